@@ -13,6 +13,7 @@
 #include "loom/optim/CombOptimizer.h"
 #include "loom/optim/GreedyOptimizer.h"
 #include "loom/optim/ILPEdgeOrderOptimizer.h"
+#include "loom/optim/ParallelTemperingOptimizer.h"
 #include "shared/rendergraph/Penalties.h"
 #include "shared/rendergraph/RenderGraph.h"
 #include "util/geo/PolyLine.h"
@@ -87,6 +88,12 @@ int main(int argc, char** argv) {
   } else if (cfg.optimMethod == "anneal-random") {
     optim::SimulatedAnnealingOptimizer annealOptim(&cfg, pens, true);
     stats = annealOptim.optimize(&g);
+  } else if (cfg.optimMethod == "anneal-pt") {
+    optim::ParallelTemperingOptimizer ptOptim(&cfg, pens, false);
+    stats = ptOptim.optimize(&g);
+  } else if (cfg.optimMethod == "anneal-pt-random") {
+    optim::ParallelTemperingOptimizer ptOptim(&cfg, pens, true);
+    stats = ptOptim.optimize(&g);
   } else if (cfg.optimMethod == "greedy") {
     optim::GreedyOptimizer greedyOptim(&cfg, pens, false);
     stats = greedyOptim.optimize(&g);
@@ -48,7 +48,9 @@ void ConfigReader::help(const char* bin) const {
             << std::setw(41) << " "
             << " comb, exhaust, hillc, hillc-random, anneal,\n"
             << std::setw(41) << " "
-            << " anneal-random, greedy, greedy-lookahead, null\n"
+            << " anneal-random, anneal-pt, anneal-pt-random,\n"
+            << std::setw(41) << " "
+            << " greedy, greedy-lookahead, null\n"
             << std::setw(41) << "  --same-seg-cross-pen arg (=4)"
             << "Penalty for same-segment crossings\n"
             << std::setw(41) << "  --diff-seg-cross-pen arg (=1)"
@@ -78,6 +80,30 @@ void ConfigReader::help(const char* bin) const {
             << " 0 means solver default\n"
             << std::setw(41) << "  --ilp-time-limit arg (=-1)"
             << "ILP solve time limit (seconds), -1 for infinite\n"
+            << std::setw(41) << "  --optim-threads arg (=0)"
+            << "Number of threads optimizing components and runs\n"
+            << std::setw(41) << " "
+            << " in parallel, 0 means one per core. Threads\n"
+            << std::setw(41) << " "
+            << " not needed for that run the anneal-pt replicas\n"
+            << std::setw(41) << "  --seed arg (=0)"
+            << "Random seed for randomized optimizers, 0 for random\n"
+            << std::setw(41) << "  --pt-replicas arg (=8)"
+            << "Number of replicas for anneal-pt\n"
+            << std::setw(41) << "  --pt-temp-min arg (=0.5)"
+            << "Temperature of the coldest anneal-pt replica\n"
+            << std::setw(41) << "  --pt-temp-max arg (=100)"
+            << "Temperature of the hottest anneal-pt replica\n"
+            << std::setw(41) << "  --pt-time-limit arg (=-1)"
+            << "anneal-pt time limit per component (seconds),\n"
+            << std::setw(41) << " "
+            << " -1 for infinite\n"
+            << std::setw(41) << "  --exhaus-iter-limit arg (=100000000)"
+            << "Max search tree nodes per component for exhaustive,\n"
+            << std::setw(41) << " "
+            << " the best ordering found is used once reached,\n"
+            << std::setw(41) << " "
+            << " 0 for no limit\n"
             << std::setw(41) << "  --dbg-output-path arg (=.)"
             << "Path used for debug output\n"
             << std::setw(41) << "  --output-optgraph"
@@ -107,6 +133,13 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
       {"dbg-output-path", required_argument, 0, 14},
       {"output-optgraph", required_argument, 0, 15},
       {"write-stats", no_argument, 0, 16},
+      {"optim-threads", required_argument, 0, 17},
+      {"seed", required_argument, 0, 18},
+      {"pt-replicas", required_argument, 0, 19},
+      {"pt-temp-min", required_argument, 0, 20},
+      {"pt-temp-max", required_argument, 0, 21},
+      {"pt-time-limit", required_argument, 0, 22},
+      {"exhaus-iter-limit", required_argument, 0, 23},
       {0, 0, 0, 0}};
 
   int c;
@@ -169,6 +202,27 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
       case 16:
         cfg->writeStats = true;
         break;
+      case 17:
+        cfg->optimThreads = atoi(optarg);
+        break;
+      case 18:
+        cfg->seed = atol(optarg);
+        break;
+      case 19:
+        cfg->ptReplicas = atoi(optarg);
+        break;
+      case 20:
+        cfg->ptTempMin = atof(optarg);
+        break;
+      case 21:
+        cfg->ptTempMax = atof(optarg);
+        break;
+      case 22:
+        cfg->ptTimeLimit = atof(optarg);
+        break;
+      case 23:
+        cfg->exhausIterLimit = atol(optarg);
+        break;
       case 'D':
         cfg->fromDot = true;
         break;
@@ -187,4 +241,15 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
         break;
     }
   }
+
+  if (cfg->ptTempMin <= 0) {
+    std::cerr << "--pt-temp-min must be greater than 0" << std::endl;
+    exit(1);
+  }
+
+  if (cfg->ptTempMax < cfg->ptTempMin) {
+    std::cerr << "--pt-temp-max must not be smaller than --pt-temp-min"
+              << std::endl;
+    exit(1);
+  }
 }
@@ -20,6 +20,23 @@ struct Config {
 
   size_t optimRuns = 1;
 
+  // 0 means one per hardware thread
+  size_t optimThreads = 0;
+
+  // 0 means random
+  size_t seed = 0;
+
+  // parallel tempering replicas, temperature ladder and time limit per
+  // component (seconds, -1 for none)
+  size_t ptReplicas = 8;
+  double ptTempMin = 0.5;
+  double ptTempMax = 100;
+  double ptTimeLimit = -1;
+
+  // maximum number of search tree nodes of the exhaustive optimizer per
+  // component, 0 for none
+  size_t exhausIterLimit = 100000000;
+
   bool outOptGraph = false;
 
   bool outputStats = false;
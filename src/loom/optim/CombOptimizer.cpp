@@ -40,7 +40,21 @@ double CombOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>& g,
 #if defined GUROBI_FOUND || defined GLPK_FOUND || defined COIN_FOUND
     return _ilpOpt.optimizeComp(og, g, hc, depth + 1, stats);
 #else
-    return _hillcOpt.optimizeComp(og, g, hc, depth + 1, stats);
+    // without an ILP solver, the branch and bound search gives optimal
+    // orderings for all components it can finish within its node budget,
+    // for all others it returns the best ordering found so far, which is
+    // at least as good as the greedy one
+    return _exhausOpt.optimizeComp(og, g, hc, depth + 1, stats);
 #endif
   }
 }
+
+// _____________________________________________________________________________
+bool CombOptimizer::threadSafe() const {
+  if (_forceILP) return false;
+#if defined GUROBI_FOUND || defined GLPK_FOUND || defined COIN_FOUND
+  return false;
+#else
+  return true;
+#endif
+}
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <unordered_map>
 #include "loom/optim/ExhaustiveOptimizer.h"
+#include "loom/optim/GreedyOptimizer.h"
 #include "shared/linegraph/Line.h"
 #include "util/log/Log.h"
 
@@ -27,95 +28,183 @@ double ExhaustiveOptimizer::optimizeComp(OptGraph* og,
 
   T_START(1);
 
-  OptOrderCfg best, cur, null;
-  double bestScore = DBL_MAX;
+  double solSp = solutionSpaceSize(g);
 
-  // fixed order list of optim graph edges
-  std::vector<OptEdge*> edges;
+  SearchCtx ctx;
+  ctx.maxIters = _cfg->exhausIterLimit;
+  ctx.aborted = false;
+
+  // the greedy ordering is the initial incumbent
+  GreedyOptimizer greedy(_cfg, _scorer.getPens(), true);
+  greedy.getFlatConfig(g, &ctx.best);
+  ctx.bestScore = _optScorer.getTotalScore(g, ctx.best);
+  ctx.iters = 0;
+
+  if (ctx.bestScore == 0) {
+    LOGTO(DEBUG, std::cerr) << prefix(depth)
+                            << "Greedy ordering already has optimal score 0";
+    writeHierarch(&ctx.best, hc);
+    return T_STOP(1);
+  }
 
+  std::vector<OptEdge*> edges;
   for (auto n : g)
     for (auto e : n->getAdjList())
       if (n == e->getFrom()) edges.push_back(e);
 
-  // this guarantees that all the orderings are sorted, which we need for
-  // std::next_permutation below!
-  initialConfig(g, &null, true);
-  cur = null;
+  // fix edges adjacent to already fixed ones first, so that node scores
+  // contribute to the bound as early as possible
+  std::set<const OptNode*> reached;
+  std::vector<bool> used(edges.size(), false);
+  while (ctx.edges.size() < edges.size()) {
+    size_t next = 0;
+    int nextConn = -1;
+    for (size_t i = 0; i < edges.size(); i++) {
+      if (used[i]) continue;
+      int conn = reached.count(edges[i]->getFrom()) +
+                 reached.count(edges[i]->getTo());
+      if (conn > nextConn ||
+          (conn == nextConn && edges[i]->pl().getCardinality() >
+                                   edges[next]->pl().getCardinality())) {
+        next = i;
+        nextConn = conn;
+      }
+    }
+
+    used[next] = true;
+    ctx.level[edges[next]] = ctx.edges.size();
+    ctx.edges.push_back(edges[next]);
+    reached.insert(edges[next]->getFrom());
+    reached.insert(edges[next]->getTo());
+  }
 
-  double iters = 0;
-  double last = 0;
-  bool running = true;
+  for (auto n : g) {
+    if (!n->pl().node || n->getDeg() < 2) continue;
+    size_t complete = 0;
+    for (auto e : n->getAdjList()) {
+      complete = std::max(complete, ctx.level[e]);
+    }
+    ctx.ndIdx[n] = ctx.complete.size();
+    ctx.complete.push_back(complete);
+  }
+
+  // split into parallel tasks once there are enough subtrees
+  double subtrees = 1;
+  ctx.splitLevel = 0;
+  while (ctx.splitLevel < ctx.edges.size() && subtrees < 256) {
+    subtrees *= util::factorial(
+        ctx.edges[ctx.splitLevel]->pl().getCardinality());
+    ctx.splitLevel++;
+  }
 
-  double curScore = _optScorer.getCrossingScore(g, cur);
-  if (_optScorer.optimizeSep())
-    curScore += _optScorer.getSeparationScore(g, cur);
+  // this guarantees that all the orderings are sorted, which we need for
+  // std::next_permutation below!
+  OptOrderCfg cur;
+  initialConfig(g, &cur, true);
+  std::vector<double> ndScores(ctx.complete.size(), 0);
+
+#pragma omp parallel
+#pragma omp single
+  branch(&ctx, &cur, &ndScores, 0, 0);
+
+  if (ctx.aborted) {
+    LOGTO(DEBUG, std::cerr) << prefix(depth) << "Stopped after "
+                            << ctx.maxIters << " of " << solSp
+                            << " iterations, best score found is "
+                            << ctx.bestScore.load();
+  } else {
+    LOGTO(DEBUG, std::cerr) << prefix(depth) << "Found optimal score "
+                            << ctx.bestScore.load() << " after "
+                            << ctx.iters.load() << " of " << solSp
+                            << " iterations!";
+  }
 
-  bestScore = curScore;
-  best = cur;
+  writeHierarch(&ctx.best, hc);
 
-  double solSp = solutionSpaceSize(g);
+  return T_STOP(1);
+}
 
-  // don't try if it is pointless, assuming we can make 100.000
-  // iterations per second
-  if ((solSp / 50000) > (60 * 60 * 6)) {
-    std::stringstream ss;
-    ss << "Exhaustive search would take too long (over "
-       << ((solSp / 50000) / (60 * 60))
-       << " hours even assuming we can check 50.000 configurations per second";
-    throw std::runtime_error(ss.str());
+// _____________________________________________________________________________
+void ExhaustiveOptimizer::branch(SearchCtx* ctx, OptOrderCfg* cur,
+                                 std::vector<double>* ndScores, double bound,
+                                 size_t k) const {
+  if (ctx->aborted || bound >= ctx->bestScore) return;
+
+  if (k == ctx->edges.size()) {
+    // all nodes are complete, the bound is the exact score
+#pragma omp critical(exhaustiveBest)
+    {
+      if (bound < ctx->bestScore) {
+        ctx->bestScore = bound;
+        ctx->best = *cur;
+      }
+    }
+    return;
   }
 
-  double itTime = 0;
+  OptEdge* e = ctx->edges[k];
+  OptNode* nds[2] = {e->getFrom(), e->getTo()};
 
-  while (true) {
-    T_START(iter);
-    if (bestScore == 0) {
-      LOGTO(DEBUG, std::cerr)
-          << prefix(depth) << "Found optimal score 0 prematurely after "
-          << iters << " iterations!";
-      writeHierarch(&best, hc);
-      return 0;
+  do {
+    if (++ctx->iters > ctx->maxIters && ctx->maxIters > 0) {
+      ctx->aborted = true;
+      return;
     }
 
-    iters++;
+    double b = bound;
+    double prev[2] = {0, 0};
 
-    if (fabs((iters - last) - 10000) < 1) {
-      LOGTO(DEBUG, std::cerr)
-          << prefix(depth) << "@ " << iters << "/" << solSp << " ("
-          << int(((1.0 * iters) / (1.0 * solSp)) * 100) << "%, "
-          << (10000 / (itTime / 1000)) << " its/s)";
-      last = iters;
-      itTime = 0;
+    for (size_t i = 0; i < 2; i++) {
+      auto it = ctx->ndIdx.find(nds[i]);
+      if (it == ctx->ndIdx.end() || (i == 1 && nds[0] == nds[1])) continue;
+      prev[i] = (*ndScores)[it->second];
+      double sc = ndBound(*ctx, nds[i], e, k, prev[i], *cur);
+      b += sc - prev[i];
+      (*ndScores)[it->second] = sc;
     }
 
-    for (size_t i = 0; i < edges.size(); i++) {
-      if (std::next_permutation(cur[edges[i]].begin(), cur[edges[i]].end())) {
-        break;
-      } else if (i == edges.size() - 1) {
-        running = false;
+    if (b < ctx->bestScore) {
+      if (k < ctx->splitLevel) {
+        OptOrderCfg subCur = *cur;
+        std::vector<double> subNdScores = *ndScores;
+#pragma omp task firstprivate(subCur, subNdScores, b, k)
+        branch(ctx, &subCur, &subNdScores, b, k + 1);
+      } else {
+        branch(ctx, cur, ndScores, b, k + 1);
       }
     }
 
-    if (!running) break;
-
-    if (_optScorer.optimizeSep())
-      curScore = _optScorer.getTotalScore(g, cur);
-    else
-      curScore = _optScorer.getCrossingScore(g, cur);
-
-    if (curScore < bestScore) {
-      bestScore = curScore;
-      best = cur;
+    // restore the node scores of both ends
+    for (size_t i = 2; i-- > 0;) {
+      auto it = ctx->ndIdx.find(nds[i]);
+      if (it == ctx->ndIdx.end() || (i == 1 && nds[0] == nds[1])) continue;
+      (*ndScores)[it->second] = prev[i];
     }
-    itTime += T_STOP(iter);
-  }
+  } while (cur->nextPermutation(e));
+}
 
-  LOGTO(DEBUG, std::cerr) << prefix(depth) << "Found optimal score "
-                          << bestScore << " after " << iters << " iterations!";
+// _____________________________________________________________________________
+double ExhaustiveOptimizer::ndBound(const SearchCtx& ctx, OptNode* n,
+                                    OptEdge* e, size_t k, double prev,
+                                    const OptOrderCfg& cur) const {
+  // with all edges fixed, the score of the node is exact
+  if (ctx.complete[ctx.ndIdx.find(n)->second] == k) {
+    return _optScorer.getTotalScore(n, cur);
+  }
 
-  writeHierarch(&best, hc);
+  // otherwise, same segment crossings and separations between e and the
+  // already fixed edges are known, all other penalties are non-negative
+  size_t crossings = 0, seps = 0;
+  for (auto eb : n->getAdjList()) {
+    if (eb == e || ctx.level.find(eb)->second >= k) continue;
+    auto ab = _optScorer.getNumCrossSeps(n, e, eb, cur);
+    auto ba = _optScorer.getNumCrossSeps(n, eb, e, cur);
+    crossings += ab.first.first;
+    seps += ab.second + ba.second;
+  }
 
-  return T_STOP(1);
+  return prev + crossings * _optScorer.getCrossingPenSameSeg(n) +
+         seps * _optScorer.getSeparationPen(n);
 }
 
 // _____________________________________________________________________________
@@ -127,42 +216,27 @@ void ExhaustiveOptimizer::initialConfig(const std::set<OptNode*>& g,
 // _____________________________________________________________________________
 void ExhaustiveOptimizer::initialConfig(const std::set<OptNode*>& g,
                                         OptOrderCfg* cfg, bool sorted) const {
-  for (OptNode* n : g) {
-    for (OptEdge* e : n->getAdjList()) {
-      if (e->getFrom() != n) continue;
-      (*cfg)[e] = std::vector<const Line*>(e->pl().getCardinality());
-      size_t p = 0;
-      for (size_t i = 0; i < e->pl().getLines().size(); i++) {
-        (*cfg)[e][p] = e->pl().getLines()[i].line;
-        p++;
-      }
+  // the orderings are initially sorted
+  *cfg = OptOrderCfg(g);
+  if (sorted) return;
 
-      if (sorted) {
-        std::sort((*cfg)[e].begin(), (*cfg)[e].end());
-      } else {
-        std::random_shuffle((*cfg)[e].begin(), (*cfg)[e].end());
-      }
-    }
+  for (auto e : cfg->getEdgs()) {
+    std::shuffle(cfg->begin(e), cfg->end(e), rng());
+    cfg->update(e);
   }
 }
 
 // _____________________________________________________________________________
 void ExhaustiveOptimizer::writeHierarch(OptOrderCfg* cfg,
                                         HierarOrderCfg* hc) const {
-  for (auto ep : *cfg) {
-    auto e = ep.first;
-
+  for (auto e : cfg->getEdgs()) {
     for (auto lnEdgPart : e->pl().lnEdgParts) {
       if (lnEdgPart.wasCut) continue;
-      for (auto r : ep.second) {
-        // get the corresponding route occurance in the opt graph edge
-        // TODO: replace this as soon as a lookup function is present in OptLO
-        OptLO optRO;
-        for (auto ro : e->pl().getLines()) {
-          if (r == ro.line) optRO = ro;
-        }
+      for (size_t i = 0; i < cfg->size(e); i++) {
+        // the corresponding route occurance in the opt graph edge
+        const OptLO* optRO = &e->pl().getLines()[cfg->lineIdx(e, i)];
 
-        for (auto rel : optRO.relatives) {
+        for (auto rel : optRO->relatives) {
           // retrieve the original line pos
           size_t p = lnEdgPart.lnEdg->pl().linePos(rel);
           if (!(lnEdgPart.dir ^ e->pl().lnEdgParts.front().dir)) {
@@ -5,6 +5,9 @@
 #ifndef LOOM_OPTIM_EXHAUSTIVEOPTIMIZER_H_
 #define LOOM_OPTIM_EXHAUSTIVEOPTIMIZER_H_
 
+#include <atomic>
+#include <unordered_map>
+#include <vector>
 #include "loom/config/LoomConfig.h"
 #include "loom/optim/OptGraph.h"
 #include "loom/optim/OptGraphScorer.h"
@@ -33,6 +36,37 @@ class ExhaustiveOptimizer : public Optimizer {
                      bool sorted) const;
   void writeHierarch(OptOrderCfg* cfg,
                      shared::rendergraph::HierarOrderCfg* c) const;
+
+ private:
+  // state of the branch and bound search, shared by all threads
+  struct SearchCtx {
+    // edges in the order they are fixed
+    std::vector<OptEdge*> edges;
+    std::unordered_map<const OptEdge*, size_t> level;
+
+    // scored nodes, and the level after which all their edges are fixed
+    std::unordered_map<const OptNode*, size_t> ndIdx;
+    std::vector<size_t> complete;
+
+    // the search tree is split into parallel tasks above this level
+    size_t splitLevel;
+
+    std::atomic<double> bestScore;
+    OptOrderCfg best;
+    std::atomic<size_t> iters;
+
+    // the search is stopped after maxIters search tree nodes (if > 0), the
+    // best ordering found so far is then used
+    size_t maxIters;
+    std::atomic<bool> aborted;
+  };
+
+  void branch(SearchCtx* ctx, OptOrderCfg* cur, std::vector<double>* ndScores,
+              double bound, size_t k) const;
+
+  // lower bound of the score of node n after fixing the k-th edge e
+  double ndBound(const SearchCtx& ctx, OptNode* n, OptEdge* e, size_t k,
+                 double prev, const OptOrderCfg& cur) const;
 };
 }  // namespace optim
 }  // namespace loom
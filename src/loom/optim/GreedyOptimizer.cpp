@@ -40,6 +40,9 @@ void GreedyOptimizer::getFlatConfig(const std::set<OptNode*>& g,
   const OptEdge* e = 0;
   SettledEdgs settled;
 
+  // only the orderings of settled edges are meaningful
+  *cfg = OptOrderCfg(g);
+
   while ((e = getNextEdge(g, &settled))) {
     Cmp left, right;
 
@@ -48,9 +51,9 @@ void GreedyOptimizer::getFlatConfig(const std::set<OptNode*>& g,
       for (const auto& lo2 : e->pl().getLines()) {
         if (lo1.line == lo2.line) continue;
         left[{lo1.line, lo2.line}] =
-            guess(lo1.line, lo2.line, e, e->getFrom(), *cfg);
+            guess(lo1.line, lo2.line, e, e->getFrom(), settled, *cfg);
         right[{lo1.line, lo2.line}] =
-            guess(lo1.line, lo2.line, e, e->getTo(), *cfg);
+            guess(lo1.line, lo2.line, e, e->getTo(), settled, *cfg);
       }
     }
 
@@ -78,12 +81,11 @@ void GreedyOptimizer::getFlatConfig(const std::set<OptNode*>& g,
       cmp = LineCmp(right, true);
     }
 
-    // fill lines into empty config
-    for (const auto& lo : e->pl().getLines()) {
-      (*cfg)[e].push_back(lo.line);
-    }
-
-    std::sort((*cfg)[e].begin(), (*cfg)[e].end(), cmp);
+    const auto& lines = e->pl().getLines();
+    std::sort(cfg->begin(e), cfg->end(e), [&lines, &cmp](size_t a, size_t b) {
+      return cmp(lines[a].line, lines[b].line);
+    });
+    cfg->update(e);
 
     settled.insert(e);
   }
@@ -131,7 +133,7 @@ const OptEdge* GreedyOptimizer::getInitialEdge(
 std::pair<int, double> GreedyOptimizer::smallerThanAt(
     const shared::linegraph::Line* a, const shared::linegraph::Line* b,
     const OptEdge* start, const OptNode* nd, const OptEdge* ign,
-    const OptOrderCfg& cfg) const {
+    const SettledEdgs& settled, const OptOrderCfg& cfg) const {
   // return -1 for false, 0 for undecided, 1 for true
   std::vector<size_t> positionsA;
   std::vector<size_t> positionsB;
@@ -146,13 +148,10 @@ std::pair<int, double> GreedyOptimizer::smallerThanAt(
     auto loB = e->pl().getLineOcc(b);
 
     if (loA && loB) {
-      auto eCfg = cfg.find(e);
-      if (eCfg != cfg.end()) {
+      if (settled.count(e)) {
         bool rev = (e->getFrom() != nd) ^ e->pl().lnEdgParts.front().dir;
-        size_t peaA = std::find(eCfg->second.begin(), eCfg->second.end(), a) -
-                      eCfg->second.begin();
-        size_t peaB = std::find(eCfg->second.begin(), eCfg->second.end(), b) -
-                      eCfg->second.begin();
+        size_t peaA = cfg.pos(e, loA - e->pl().getLines().data());
+        size_t peaB = cfg.pos(e, loB - e->pl().getLines().data());
         if (rev) {
           positionsA.push_back(offset + peaA);
           positionsB.push_back(offset + peaB);
@@ -185,6 +184,7 @@ std::pair<bool, double> GreedyOptimizer::guess(const shared::linegraph::Line* a,
                                                const shared::linegraph::Line* b,
                                                const OptEdge* start,
                                                const OptNode* refNd,
+                                               const SettledEdgs& settled,
                                                const OptOrderCfg& cfg) const {
   int dec = 0;
   bool notRef = false;
@@ -195,7 +195,7 @@ std::pair<bool, double> GreedyOptimizer::guess(const shared::linegraph::Line* a,
   auto e = start;
   auto curNd = refNd;
   while (true) {
-    auto i = smallerThanAt(a, b, e, curNd, e, cfg);
+    auto i = smallerThanAt(a, b, e, curNd, e, settled, cfg);
     if (i.first != 0) {
       dec = i.first;
       cost = i.second;
@@ -210,7 +210,7 @@ std::pair<bool, double> GreedyOptimizer::guess(const shared::linegraph::Line* a,
     e = start;
     curNd = start->getOtherNd(refNd);
     while (true) {
-      auto i = smallerThanAt(a, b, e, curNd, e, cfg);
+      auto i = smallerThanAt(a, b, e, curNd, e, settled, cfg);
       if (i.first != 0) {
         dec = i.first;
         cost = i.second;
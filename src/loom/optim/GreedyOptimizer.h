@@ -59,11 +59,13 @@ class GreedyOptimizer : public ExhaustiveOptimizer {
   std::pair<bool, double> guess(const shared::linegraph::Line* a,
                                 const shared::linegraph::Line* b,
                                 const OptEdge* start, const OptNode* refNd,
+                                const SettledEdgs& settled,
                                 const OptOrderCfg& cfg) const;
   std::pair<int, double> smallerThanAt(const shared::linegraph::Line* a,
                                        const shared::linegraph::Line* b,
                                        const OptEdge* e, const OptNode* nd,
                                        const OptEdge* ignore,
+                                       const SettledEdgs& settled,
                                        const OptOrderCfg& cfg) const;
 
   const OptEdge* eligibleNextEdge(const OptEdge* start, const OptNode* nd,
@@ -6,6 +6,7 @@
 #include <unordered_map>
 #include "loom/optim/GreedyOptimizer.h"
 #include "loom/optim/HillClimbOptimizer.h"
+#include "loom/optim/SwapScorer.h"
 #include "shared/linegraph/Line.h"
 #include "util/log/Log.h"
 
@@ -21,6 +22,7 @@ double HillClimbOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>&
                                      OptResStats& stats) const {
   UNUSED(stats);
   UNUSED(depth);
+  UNUSED(og);
   T_START(1);
   OptOrderCfg cur;
 
@@ -40,49 +42,32 @@ double HillClimbOptimizer::optimizeComp(OptGraph* og, const std::set<OptNode*>&
     greedy.getFlatConfig(g, &cur);
   }
 
+  SwapScorer scorer(_optScorer, g, &cur);
+
   while (true) {
     double bestChange = 0;
     OptEdge* bestEdge = 0;
-    std::vector<const Line*> bestOrder;
+    size_t bestP1 = 0, bestP2 = 0;
 
     for (size_t i = 0; i < edges.size(); i++) {
-      double oldScore = getScore(og, edges[i], cur);
-
-      for (size_t p1 = 0; p1 < cur[edges[i]].size(); p1++) {
-        for (size_t p2 = p1; p2 < cur[edges[i]].size(); p2++) {
-          // switch p1 and p2
-          auto tmp = cur[edges[i]][p1];
-          cur[edges[i]][p1] = cur[edges[i]][p2];
-          cur[edges[i]][p2] = tmp;
-
-          double s = getScore(og, edges[i], cur);
-          if (s < oldScore && oldScore - s > bestChange) {
-            bestChange = oldScore - s;
+      for (size_t p1 = 0; p1 < cur.size(edges[i]); p1++) {
+        for (size_t p2 = p1 + 1; p2 < cur.size(edges[i]); p2++) {
+          double d = scorer.delta(edges[i], p1, p2);
+          if (-d > bestChange) {
+            bestChange = -d;
             bestEdge = edges[i];
-            bestOrder = cur[edges[i]];
+            bestP1 = p1;
+            bestP2 = p2;
           }
-
-          // switch back
-          tmp = cur[edges[i]][p1];
-          cur[edges[i]][p1] = cur[edges[i]][p2];
-          cur[edges[i]][p2] = tmp;
         }
       }
     }
 
     if (bestEdge == 0) break;
 
-    cur[bestEdge] = bestOrder;
+    scorer.swap(bestEdge, bestP1, bestP2);
   }
 
   writeHierarch(&cur, hc);
   return T_STOP(1);
 }
-
-// _____________________________________________________________________________
-double HillClimbOptimizer::getScore(OptGraph* og, OptEdge* e,
-                                    OptOrderCfg& cur) const {
-  UNUSED(og);
-  if (_optScorer.optimizeSep()) return _optScorer.getTotalScore(e, cur);
-  return _optScorer.getCrossingScore(e, cur);
-}
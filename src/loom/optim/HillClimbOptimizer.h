@@ -28,8 +28,6 @@ class HillClimbOptimizer : public ExhaustiveOptimizer {
                            OptResStats& stats) const;
 
  protected:
-  double getScore(OptGraph* og, OptEdge* e, OptOrderCfg& cur) const;
-
   bool _randomStart;
 };
 }  // namespace optim
@@ -28,6 +28,9 @@ class ILPOptimizer : public Optimizer {
 
   virtual std::string getName() const { return "ilp";}
 
+  // ILP solvers are not guaranteed to be safe to use from multiple threads
+  virtual bool threadSafe() const { return false; }
+
  protected:
   const loom::optim::ExhaustiveOptimizer _exhausOpt;
   virtual shared::optim::ILPSolver* createProblem(
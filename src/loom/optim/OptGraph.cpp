@@ -2,6 +2,8 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
+#include <algorithm>
+#include <cassert>
 #include <set>
 #include "loom/optim/OptGraph.h"
 #include "loom/optim/OptGraphScorer.h"
@@ -20,6 +22,7 @@ using loom::optim::OptGraphScorer;
 using loom::optim::OptLO;
 using loom::optim::OptNode;
 using loom::optim::OptNodePL;
+using loom::optim::OptOrderCfg;
 using loom::optim::PartnerPath;
 using shared::linegraph::Line;
 using shared::linegraph::LineEdge;
@@ -66,6 +69,43 @@ LnEdgPart OptGraph::getLastLnEdgPart(const OptEdge* optEdg) {
   return optEdg->pl().lnEdgParts[optEdg->pl().lastLnEdg];
 }
 
+// _____________________________________________________________________________
+OptOrderCfg::OptOrderCfg(const std::set<OptNode*>& g) : _off(1, 0) {
+  for (auto n : g) {
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      assert(e->pl().idx == _edgs.size());
+      _edgs.push_back(e);
+      for (size_t l = 0; l < e->pl().getLines().size(); l++) {
+        _ord.push_back(l);
+        _pos.push_back(l);
+      }
+      _off.push_back(_ord.size());
+    }
+  }
+}
+
+// _____________________________________________________________________________
+void OptOrderCfg::update(const OptEdge* e) {
+  size_t off = _off[e->pl().idx];
+  for (size_t p = 0; p < size(e); p++) _pos[off + _ord[off + p]] = p;
+}
+
+// _____________________________________________________________________________
+void OptOrderCfg::swap(const OptEdge* e, size_t p1, size_t p2) {
+  size_t off = _off[e->pl().idx];
+  std::swap(_ord[off + p1], _ord[off + p2]);
+  _pos[off + _ord[off + p1]] = p1;
+  _pos[off + _ord[off + p2]] = p2;
+}
+
+// _____________________________________________________________________________
+bool OptOrderCfg::nextPermutation(const OptEdge* e) {
+  bool ret = std::next_permutation(begin(e), end(e));
+  update(e);
+  return ret;
+}
+
 // _____________________________________________________________________________
 const std::vector<OptLO>& OptEdgePL::getLines() const { return lines; }
 
@@ -92,6 +132,13 @@ const OptLO* OptEdgePL::getLineOcc(const Line* l) const {
   return &*it;
 }
 
+// _____________________________________________________________________________
+int OptEdgePL::getLineIdx(const Line* l) const {
+  const OptLO* lo = getLineOcc(l);
+  if (!lo) return -1;
+  return lo - lines.data();
+}
+
 // _____________________________________________________________________________
 std::string OptEdgePL::getStrRepr() const {
   const void* address = static_cast<const void*>(this);
@@ -315,6 +362,18 @@ Nullable<const OptLO> OptGraph::getLO(const OptEdge* a, const Line* r) {
   return Nullable<const OptLO>();
 }
 
+// _____________________________________________________________________________
+void OptGraph::writeEdgIdxs(const std::set<OptNode*>& comp) {
+  // same iteration order as in the OptOrderCfg constructor
+  size_t idx = 0;
+  for (auto n : comp) {
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      e->pl().idx = idx++;
+    }
+  }
+}
+
 // _____________________________________________________________________________
 std::vector<PartnerPath> OptGraph::getPartnerLines() const {
   std::vector<PartnerPath> ret;
@@ -5,8 +5,10 @@
 #ifndef LOOM_GRAPH_OPTIM_OPTGRAPH_H_
 #define LOOM_GRAPH_OPTIM_OPTGRAPH_H_
 
+#include <cstdint>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "shared/linegraph/LineGraph.h"
 #include "shared/rendergraph/RenderGraph.h"
@@ -25,10 +27,6 @@ class OptGraphScorer;
 typedef util::graph::Node<OptNodePL, OptEdgePL> OptNode;
 typedef util::graph::Edge<OptNodePL, OptEdgePL> OptEdge;
 
-typedef std::map<const loom::optim::OptEdge*,
-                 std::vector<const shared::linegraph::Line*>>
-    OptOrderCfg;
-
 struct OptLO {
   OptLO() : line(0), dir(0) {}
   OptLO(const shared::linegraph::Line* r,
@@ -80,7 +78,7 @@ struct LnEdgPart {
 };
 
 struct OptEdgePL {
-  OptEdgePL() : depth(0), firstLnEdg(0), lastLnEdg(0){};
+  OptEdgePL() : depth(0), firstLnEdg(0), lastLnEdg(0), idx(0){};
 
   // all original line edges from the transit graph contained in this edge
   // Guarantee: they are all equal in terms of (directed) routes
@@ -91,6 +89,9 @@ struct OptEdgePL {
   size_t firstLnEdg;
   size_t lastLnEdg;
 
+  // dense index of this edge in its component, see OptGraph::writeEdgIdxs()
+  size_t idx;
+
   size_t getCardinality() const;
   std::string toStr() const;
   std::vector<OptLO>& getLines();
@@ -98,6 +99,10 @@ struct OptEdgePL {
 
   const OptLO* getLineOcc(const shared::linegraph::Line* l) const;
 
+  // dense index of line l in this edge (its position in lines), -1 if the
+  // line does not occur
+  int getLineIdx(const shared::linegraph::Line* l) const;
+
   // partial routes
   // For the line edge parts contained in lnEdgParts, only these route
   // occurances are actually contained in this edge. Their relative ordering is
@@ -130,6 +135,66 @@ struct OptNodePL {
   std::map<OptEdge*, size_t> circOrderMap;
 };
 
+// Line orderings of all edges of an optim graph component, held in flat
+// arrays. Edges are identified by their dense index in the component
+// (OptEdgePL::idx, see OptGraph::writeEdgIdxs()), lines by their dense index
+// in the edge (OptEdgePL::getLineIdx()). For each edge, the ordering holds
+// the line at each position, and the inverse ordering the position of each
+// line.
+class OptOrderCfg {
+ public:
+  OptOrderCfg() : _off(1, 0) {}
+
+  // the orderings of all edges of component g, initially sorted by line
+  // index. The edge indices of g must have been written before.
+  explicit OptOrderCfg(const std::set<OptNode*>& g);
+
+  // the edges of the component, by index
+  const std::vector<OptEdge*>& getEdgs() const { return _edgs; }
+
+  // number of lines on edge e
+  size_t size(const OptEdge* e) const {
+    return _off[e->pl().idx + 1] - _off[e->pl().idx];
+  }
+
+  // dense index of the line at position p on edge e
+  size_t lineIdx(const OptEdge* e, size_t p) const {
+    return _ord[_off[e->pl().idx] + p];
+  }
+
+  // position of the line with dense index l on edge e
+  size_t pos(const OptEdge* e, size_t l) const {
+    return _pos[_off[e->pl().idx] + l];
+  }
+
+  // the ordering of edge e, which may be permuted in place. The positions
+  // of e are only valid again after a call to update(e).
+  uint32_t* begin(const OptEdge* e) {
+    return _ord.data() + _off[e->pl().idx];
+  }
+  uint32_t* end(const OptEdge* e) {
+    return _ord.data() + _off[e->pl().idx + 1];
+  }
+
+  // rewrite the positions of edge e from its ordering
+  void update(const OptEdge* e);
+
+  // swap the lines at positions p1 and p2 of edge e
+  void swap(const OptEdge* e, size_t p1, size_t p2);
+
+  // permute the ordering of edge e into the lexicographically next one, see
+  // std::next_permutation()
+  bool nextPermutation(const OptEdge* e);
+
+ private:
+  std::vector<OptEdge*> _edgs;
+
+  // the orderings of edge i are at [_off[i], _off[i + 1])
+  std::vector<size_t> _off;
+  std::vector<uint32_t> _ord;
+  std::vector<uint32_t> _pos;
+};
+
 class OptGraph : public util::graph::UndirGraph<OptNodePL, OptEdgePL> {
  public:
   OptGraph(const OptGraphScorer* scorer) : _scorer(scorer){};
@@ -150,6 +215,10 @@ class OptGraph : public util::graph::UndirGraph<OptNodePL, OptEdgePL> {
   void untangle();
   void partnerLines();
 
+  // write dense indices to the edges of component comp, as used by
+  // OptOrderCfg. Must be called again after the component changed.
+  static void writeEdgIdxs(const std::set<OptNode*>& comp);
+
   std::vector<PartnerPath> getPartnerLines() const;
   PartnerPath pathFromComp(const std::set<OptNode*>& comp) const;
 
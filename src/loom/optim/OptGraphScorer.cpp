@@ -2,7 +2,8 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
-#include <map>
+#include <limits>
+#include <vector>
 #include "loom/optim/OptGraph.h"
 #include "loom/optim/OptGraphScorer.h"
 #include "loom/optim/Optimizer.h"
@@ -181,34 +182,28 @@ std::pair<std::pair<size_t, size_t>, size_t> OptGraphScorer::getNumCrossSeps(
 // _____________________________________________________________________________
 size_t OptGraphScorer::getNumCrossDiffSeg(OptNode* n, OptEdge* ea,
                                           const OptOrderCfg& c) const {
-  std::map<const Line*, size_t> ordering;
-
   bool revA = (ea->getFrom() != n) ^ ea->pl().lnEdgParts.front().dir;
 
-  const auto& cea = c.at(ea);
-
-  for (size_t i = 0; i < cea.size(); i++) {
-    const auto& l = cea[i];
-    ordering[l] = revA ? cea.size() - 1 - i : i;
-  }
+  size_t cardA = c.size(ea);
+  const auto& eaLines = ea->pl().getLines();
 
   std::vector<size_t> relOrderCross;
 
   for (const auto& eb : OptGraph::clockwEdges(ea, n)) {
-    const auto& ceb = c.at(eb);
+    size_t cardB = c.size(eb);
     bool revB = (eb->getFrom() != n) ^ eb->pl().lnEdgParts.front().dir;
 
-    for (size_t i = 0; i < ceb.size(); i++) {
-      const auto& thisLine = ceb[!revB ? ceb.size() - 1 - i : i];
+    for (size_t i = 0; i < cardB; i++) {
+      const auto* ebLo =
+          &eb->pl().getLines()[c.lineIdx(eb, !revB ? cardB - 1 - i : i)];
 
-      auto otherIt = ordering.find(thisLine);
-      if (otherIt == ordering.end()) continue;
+      int a = ea->pl().getLineIdx(ebLo->line);
+      if (a < 0) continue;
 
-      const auto* eaLo = ea->pl().getLineOcc(otherIt->first);
-      const auto* ebLo = eb->pl().getLineOcc(thisLine);
+      const auto* eaLo = &eaLines[a];
 
-      assert(eaLo);
-      assert(ebLo);
+      size_t otherPos = c.pos(ea, a);
+      if (revA) otherPos = cardA - 1 - otherPos;
 
       if ((eaLo->dir == 0 || ebLo->dir == 0 ||
            (eaLo->dir == n->pl().node && ebLo->dir != n->pl().node) ||
@@ -216,7 +211,7 @@ size_t OptGraphScorer::getNumCrossDiffSeg(OptNode* n, OptEdge* ea,
           (n->pl().node->pl().connOccurs(eaLo->line, OptGraph::getAdjEdg(ea, n),
                                          OptGraph::getAdjEdg(eb, n)))) {
         // connection occurs, consider for crossings
-        relOrderCross.push_back(otherIt->second);
+        relOrderCross.push_back(otherPos);
       }
     }
   }
@@ -229,37 +224,31 @@ std::pair<std::pair<size_t, size_t>, size_t> OptGraphScorer::getNumCrossSeps(
     OptNode* n, OptEdge* ea, OptEdge* eb, const OptOrderCfg& c) const {
   std::pair<std::pair<size_t, size_t>, size_t> ret{{0, 0}, 0};
 
-  std::map<const Line*, size_t> ordering;
-
   bool revA = (ea->getFrom() != n) ^ ea->pl().lnEdgParts.front().dir;
   bool revB = (eb->getFrom() != n) ^ eb->pl().lnEdgParts.front().dir;
 
   bool rev = !(revA ^ revB);
 
-  const auto& cea = c.at(ea);
-  const auto& ceb = c.at(eb);
-
-  for (size_t i = 0; i < cea.size(); i++) {
-    ordering[cea[i]] = rev ? cea.size() - 1 - i : i;
-  }
+  size_t cardA = c.size(ea);
+  const auto& eaLines = ea->pl().getLines();
 
   std::vector<size_t> relOrderCross, relOrderSep;
 
-  for (size_t i = 0; i < ceb.size(); i++) {
-    const auto& thisLine = ceb[i];
+  for (size_t i = 0; i < c.size(eb); i++) {
+    const auto* ebLo = &eb->pl().getLines()[c.lineIdx(eb, i)];
+
+    int a = ea->pl().getLineIdx(ebLo->line);
 
-    auto otherIt = ordering.find(thisLine);
-    if (otherIt == ordering.end()) {
+    if (a < 0) {
       // insert a placeholder for separations, otherwise ignore
       relOrderSep.push_back(std::numeric_limits<size_t>::max());
       continue;
     }
 
-    const auto* eaLo = ea->pl().getLineOcc(otherIt->first);
-    const auto* ebLo = eb->pl().getLineOcc(thisLine);
+    const auto* eaLo = &eaLines[a];
 
-    assert(eaLo);
-    assert(ebLo);
+    size_t otherPos = c.pos(ea, a);
+    if (rev) otherPos = cardA - 1 - otherPos;
 
     if ((eaLo->dir == 0 || ebLo->dir == 0 ||
          (eaLo->dir == n->pl().node && ebLo->dir != n->pl().node) ||
@@ -267,8 +256,8 @@ std::pair<std::pair<size_t, size_t>, size_t> OptGraphScorer::getNumCrossSeps(
         (n->pl().node->pl().connOccurs(eaLo->line, OptGraph::getAdjEdg(ea, n),
                                        OptGraph::getAdjEdg(eb, n)))) {
       // connection occurs, consider for crossings
-      relOrderCross.push_back(otherIt->second);
-      relOrderSep.push_back(otherIt->second);
+      relOrderCross.push_back(otherPos);
+      relOrderSep.push_back(otherPos);
     } else {
       // otherwise insert a placeholder
       relOrderSep.push_back(std::numeric_limits<size_t>::max());
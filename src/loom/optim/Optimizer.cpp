@@ -2,8 +2,12 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
+#include <algorithm>
+#include <cassert>
 #include <fstream>
 #include <numeric>
+#include <random>
+#include <thread>
 #include "loom/optim/NullOptimizer.h"
 #include "loom/optim/OptGraph.h"
 #include "loom/optim/OptGraphScorer.h"
@@ -12,6 +16,12 @@
 #include "util/geo/output/GeoGraphJsonOutput.h"
 #include "util/graph/Algorithm.h"
 #include "util/log/Log.h"
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_set_num_threads(n)
+#define omp_set_max_active_levels(l)
+#endif
 
 using loom::optim::EdgePair;
 using loom::optim::LinePair;
@@ -110,6 +120,9 @@ OptResStats Optimizer::optimize(RenderGraph* rg) const {
   // iterate over components and optimize all of them separately
   const auto& comps = util::graph::Algorithm::connectedComponents(g);
 
+  // written once here, the components are optimized in parallel below
+  for (const auto& nds : comps) OptGraph::writeEdgIdxs(nds);
+
   optResStats.numNodes = g.getNumNodes();
   optResStats.numEdges = g.getNumEdges();
   optResStats.maxLineCard = maxCard(g.getNds());
@@ -153,75 +166,153 @@ OptResStats Optimizer::optimize(RenderGraph* rg) const {
   double bestScore = std::numeric_limits<double>::infinity();
   OrderCfg bestCfg;
 
+  std::vector<const std::set<OptNode*>*> compList;
+  for (const auto& nds : comps) compList.push_back(&nds);
+
+  double maxCompSolSpace = 0;
+  size_t maxCompC = 0;
+  size_t maxNumNodes = 0;
+  size_t maxNumEdges = 0;
+  size_t numM1Comps = 0;
+
+  if (_cfg->outputStats) {
+    for (const auto* nds : compList) {
+      size_t maxC = maxCard(*nds);
+      double solSp = solutionSpaceSize(*nds);
+
+      // skip trivial components
+      if (nds->size() > 2) {
+        if (maxC > maxCompC) maxCompC = maxC;
+        if (solSp > maxCompSolSpace) maxCompSolSpace = solSp;
+        if (solSp == 1) numM1Comps++;
+        if (nds->size() > maxNumNodes) maxNumNodes = nds->size();
+        if (numEdges(*nds) > maxNumEdges) maxNumEdges = numEdges(*nds);
+
+        LOGTO(INFO, std::cerr)
+            << " (stats) Optimizing subgraph of size " << nds->size()
+            << " with max cardinality = " << maxC
+            << " and solution space size = " << solSp;
+      }
+    }
+  }
+
+  // every component of every run is optimized independently, with its own
+  // random stream, and merged per run afterwards
+  size_t numTasks = runs * compList.size();
+  std::vector<HierarOrderCfg> taskHcs(numTasks);
+  std::vector<double> taskTimes(numTasks, 0);
+  std::vector<OptResStats> taskStats(numTasks, optResStats);
+
+  // largest components first, to not end up waiting for a single big
+  // component started last
+  std::vector<size_t> taskOrder(numTasks);
+  std::iota(taskOrder.begin(), taskOrder.end(), 0);
+  std::vector<double> compSolSp;
+  for (const auto* nds : compList) compSolSp.push_back(solutionSpaceSize(*nds));
+  std::stable_sort(taskOrder.begin(), taskOrder.end(),
+                   [&compSolSp](size_t a, size_t b) {
+                     return compSolSp[a % compSolSp.size()] >
+                            compSolSp[b % compSolSp.size()];
+                   });
+
+  size_t seed = _cfg->seed ? _cfg->seed : rand();
+
+  size_t totThreads = _cfg->optimThreads;
+  if (totThreads == 0) totThreads = std::thread::hardware_concurrency();
+  if (totThreads == 0) totThreads = 1;
+
+  size_t threads = totThreads;
+  if (!threadSafe()) threads = 1;
+  threads = std::max<size_t>(1, std::min(threads, numTasks));
+
+  // threads not needed for the tasks are split evenly among them, to be used
+  // by optimizers which parallelize a single component (anneal-pt)
+  int innerThreads = std::max<size_t>(1, totThreads / threads);
+  omp_set_max_active_levels(2);
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(threads) \
+    if (threads > 1)
+  for (size_t j = 0; j < numTasks; j++) {
+    omp_set_num_threads(innerThreads);
+
+    size_t i = taskOrder[j];
+    size_t run = i / compList.size();
+    size_t comp = i % compList.size();
+    const auto& nds = *compList[comp];
+
+    // the stream only depends on the seed, the run and the component, not
+    // on the thread scheduling
+    std::seed_seq seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(run),
+                      static_cast<uint32_t>(comp)};
+    rng().seed(seq);
+
+    auto& stats = taskStats[i];
+    stats.maxNumRowsPerComp = 0;
+    stats.maxNumColsPerComp = 0;
+
+    // this is the implementation of the single edge pruning described in the
+    // publication - simple skip such components
+    // we also skip components with only single edges
+    if (maxC > 1 && nds.size() > 2) {
+      taskTimes[i] = optimizeComp(&g, nds, &taskHcs[i], stats);
+    } else {
+      taskTimes[i] = nullOpt.optimizeComp(&g, nds, &taskHcs[i], 0, stats);
+    }
+  }
+
+  optResStats.maxNumRowsPerComp = 0;
+  optResStats.maxNumColsPerComp = 0;
+  for (const auto& stats : taskStats) {
+    optResStats.maxNumRowsPerComp =
+        std::max(optResStats.maxNumRowsPerComp, stats.maxNumRowsPerComp);
+    optResStats.maxNumColsPerComp =
+        std::max(optResStats.maxNumColsPerComp, stats.maxNumColsPerComp);
+  }
+
+  optResStats.nonTrivialComponents = nonTrivialComponents;
+  optResStats.numCompsSolSpaceOne = numM1Comps;
+  optResStats.maxNumNodesPerComp = maxNumNodes;
+  optResStats.maxNumEdgesPerComp = maxNumEdges;
+  optResStats.maxCardPerComp = maxCompC;
+  optResStats.maxCompSolSpace = maxCompSolSpace;
+
+  if (_cfg->outputStats) {
+    LOGTO(INFO, std::cerr) << "(stats) Number of nontrivial components: "
+                           << optResStats.nonTrivialComponents;
+    LOGTO(INFO, std::cerr)
+        << "(stats) Number of nontrivial components with sol space size 1: "
+        << optResStats.numCompsSolSpaceOne;
+    LOGTO(INFO, std::cerr)
+        << "(stats) Max number of nodes of all nontrivial components: "
+        << optResStats.maxNumNodesPerComp;
+    LOGTO(INFO, std::cerr)
+        << "(stats) Max number of edges of all nontrivial components: "
+        << optResStats.maxNumEdgesPerComp;
+    LOGTO(INFO, std::cerr)
+        << "(stats) Max cardinality of all nontrivial components: "
+        << optResStats.maxCardPerComp;
+    LOGTO(INFO, std::cerr)
+        << "(stats) Max solution space size of all nontrivial components: "
+        << optResStats.maxCompSolSpace;
+  }
+
   for (size_t run = 0; run < runs; run++) {
     OrderCfg c;
     HierarOrderCfg hc;
 
     double t = 0;
-    double maxCompSolSpace = 0;
-    size_t maxCompC = 0;
-    size_t maxNumNodes = 0;
-    size_t maxNumEdges = 0;
-    size_t numM1Comps = 0;
-
-    optResStats.maxNumRowsPerComp = 0;
-    optResStats.maxNumColsPerComp = 0;
-
-    for (const auto& nds : comps) {
-      if (_cfg->outputStats) {
-        size_t maxC = maxCard(nds);
-        double solSp = solutionSpaceSize(nds);
-
-        // skip trivial components
-        if (nds.size() > 2) {
-          if (maxC > maxCompC) maxCompC = maxC;
-          if (solSp > maxCompSolSpace) maxCompSolSpace = solSp;
-          if (solSp == 1) numM1Comps++;
-          if (nds.size() > maxNumNodes) maxNumNodes = nds.size();
-          if (numEdges(nds) > maxNumEdges) maxNumEdges = numEdges(nds);
-
-          LOGTO(INFO, std::cerr)
-              << " (stats) Optimizing subgraph of size " << nds.size()
-              << " with max cardinality = " << maxC
-              << " and solution space size = " << solSp;
-        }
-      }
 
-      // this is the implementation of the single edge pruning described in the
-      // publication - simple skip such components
-      // we also skip components with only single edges
-      if (maxC > 1 && nds.size() > 2) {
-        t += optimizeComp(&g, nds, &hc, optResStats);
-      } else {
-        t += nullOpt.optimizeComp(&g, nds, &hc, 0, optResStats);
+    // components write disjoint line edge parts
+    for (size_t comp = 0; comp < compList.size(); comp++) {
+      size_t i = run * compList.size() + comp;
+      t += taskTimes[i];
+      for (const auto& lnEdg : taskHcs[i]) {
+        for (const auto& ordering : lnEdg.second) {
+          auto& o = hc[lnEdg.first][ordering.first];
+          o.insert(o.end(), ordering.second.begin(), ordering.second.end());
+        }
       }
-    }
-
-    optResStats.nonTrivialComponents = nonTrivialComponents;
-    optResStats.numCompsSolSpaceOne = numM1Comps;
-    optResStats.maxNumNodesPerComp = maxNumNodes;
-    optResStats.maxNumEdgesPerComp = maxNumEdges;
-    optResStats.maxCardPerComp = maxCompC;
-    optResStats.maxCompSolSpace = maxCompSolSpace;
-
-    if (_cfg->outputStats) {
-      LOGTO(INFO, std::cerr) << "(stats) Number of nontrivial components: "
-                             << optResStats.nonTrivialComponents;
-      LOGTO(INFO, std::cerr)
-          << "(stats) Number of nontrivial components with sol space size 1: "
-          << optResStats.numCompsSolSpaceOne;
-      LOGTO(INFO, std::cerr)
-          << "(stats) Max number of nodes of all nontrivial components: "
-          << optResStats.maxNumNodesPerComp;
-      LOGTO(INFO, std::cerr)
-          << "(stats) Max number of edges of all nontrivial components: "
-          << optResStats.maxNumEdgesPerComp;
-      LOGTO(INFO, std::cerr)
-          << "(stats) Max cardinality of all nontrivial components: "
-          << optResStats.maxCardPerComp;
-      LOGTO(INFO, std::cerr)
-          << "(stats) Max solution space size of all nontrivial components: "
-          << optResStats.maxCompSolSpace;
+      HierarOrderCfg().swap(taskHcs[i]);
     }
 
     hc.writeFlatCfg(&c);
@@ -489,8 +580,9 @@ double Optimizer::optimizeComp(OptGraph* g, const std::set<OptNode*>& cmp,
 // _____________________________________________________________________________
 OptOrderCfg Optimizer::getOptOrderCfg(
     const shared::rendergraph::OrderCfg& cfg,
-    const std::map<const LineNode*, OptNode*>& ndMap, const OptGraph* g) {
-  OptOrderCfg ret;
+    const std::map<const LineNode*, OptNode*>& ndMap, OptGraph* g) {
+  OptGraph::writeEdgIdxs(g->getNds());
+  OptOrderCfg ret(g->getNds());
   for (auto i : cfg) {
     auto e = i.first;
     auto order = i.second;
@@ -499,15 +591,27 @@ OptOrderCfg Optimizer::getOptOrderCfg(
     auto opNdTo = ndMap.find(e->getTo())->second;
     auto opEdg = g->getEdg(opNdFr, opNdTo);
 
+    // the optim graph was built from the line graph without any
+    // simplification, so both edges hold the same lines
+    assert(ret.size(opEdg) == order.size());
+
+    auto it = ret.begin(opEdg);
     for (auto pos = order.rbegin(); pos != order.rend(); pos++) {
       auto lo = e->pl().lineOccAtPos(*pos);
-      ret[opEdg].push_back(lo.line);
+      *it++ = opEdg->pl().getLineIdx(lo.line);
     }
+    ret.update(opEdg);
   }
 
   return ret;
 }
 
+// _____________________________________________________________________________
+std::mt19937& Optimizer::rng() {
+  static thread_local std::mt19937 rng;
+  return rng;
+}
+
 // _____________________________________________________________________________
 std::string Optimizer::prefix(size_t depth) {
   std::stringstream ret;
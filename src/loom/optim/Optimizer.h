@@ -2,6 +2,7 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
+#include <random>
 #include "loom/config/LoomConfig.h"
 #include "loom/optim/OptGraph.h"
 #include "loom/optim/OptGraphScorer.h"
@@ -72,17 +73,24 @@ class Optimizer {
 
   virtual std::string getName() const = 0;
 
+  // whether components may be optimized in parallel threads
+  virtual bool threadSafe() const { return true; }
+
  protected:
   const config::Config* _cfg;
   const OptGraphScorer _scorer;
 
   static std::string prefix(size_t depth);
 
+  // random number generator of the calling thread, seeded for each
+  // component and run in optimize()
+  static std::mt19937& rng();
+
  private:
   static OptOrderCfg getOptOrderCfg(
       const shared::rendergraph::OrderCfg&,
       const std::map<const shared::linegraph::LineNode*, OptNode*>& ndMap,
-      const OptGraph* g);
+      OptGraph* g);
 };
 }  // namespace optim
 }  // namespace loom
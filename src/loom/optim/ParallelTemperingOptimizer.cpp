@@ -0,0 +1,146 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include "loom/optim/GreedyOptimizer.h"
+#include "loom/optim/ParallelTemperingOptimizer.h"
+#include "util/log/Log.h"
+
+using loom::optim::OptEdge;
+using loom::optim::OptNode;
+using loom::optim::OptOrderCfg;
+using loom::optim::ParallelTemperingOptimizer;
+using loom::optim::SwapScorer;
+using shared::rendergraph::HierarOrderCfg;
+
+// _____________________________________________________________________________
+double ParallelTemperingOptimizer::optimizeComp(OptGraph* og,
+                                                const std::set<OptNode*>& g,
+                                                HierarOrderCfg* hc,
+                                                size_t depth,
+                                                OptResStats& stats) const {
+  T_START(1);
+  UNUSED(og);
+  UNUSED(stats);
+
+  // fixed order list of optim graph edges
+  std::vector<OptEdge*> edges;
+
+  for (auto n : g)
+    for (auto e : n->getAdjList())
+      if (n == e->getFrom() && e->pl().getCardinality() > 1) edges.push_back(e);
+
+  size_t numReplicas = std::max<size_t>(1, _cfg->ptReplicas);
+
+  // geometric temperature ladder, index 0 is the coldest
+  std::vector<double> temps(numReplicas, _cfg->ptTempMin);
+  for (size_t k = 1; k < numReplicas; k++) {
+    temps[k] = _cfg->ptTempMin * pow(_cfg->ptTempMax / _cfg->ptTempMin,
+                                     k / (numReplicas - 1.0));
+  }
+
+  OptOrderCfg start;
+  if (!_randomStart) {
+    // take the greedy optimized ordering as a starting point
+    GreedyOptimizer greedy(_cfg, _scorer.getPens(), true);
+    greedy.getFlatConfig(g, &start);
+  }
+
+  std::vector<OptOrderCfg> cfgs(numReplicas);
+  std::vector<std::unique_ptr<SwapScorer>> scorers;
+  std::vector<double> scores(numReplicas);
+  std::vector<std::mt19937> rngs;
+
+  for (size_t r = 0; r < numReplicas; r++) {
+    if (_randomStart) {
+      initialConfig(g, &cfgs[r], false);
+    } else {
+      cfgs[r] = start;
+    }
+    scorers.emplace_back(new SwapScorer(_optScorer, g, &cfgs[r]));
+    scores[r] = _optScorer.getTotalScore(g, cfgs[r]);
+
+    // replicas get their own streams, derived from the component's stream
+    rngs.emplace_back(rng()());
+  }
+
+  // the replica currently at each temperature
+  std::vector<size_t> atTemp(numReplicas);
+  std::iota(atTemp.begin(), atTemp.end(), 0);
+
+  size_t best = std::min_element(scores.begin(), scores.end()) - scores.begin();
+  double bestScore = scores[best];
+  OptOrderCfg bestCfg = cfgs[best];
+
+  std::uniform_real_distribution<double> unif(0, 1);
+
+  size_t rounds = 0;
+  size_t lastImpr = 0;
+
+  size_t ABORT_AFTER_UNCH = 20;
+
+  while (bestScore > 0 && rounds - lastImpr <= ABORT_AFTER_UNCH) {
+    rounds++;
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (size_t k = 0; k < numReplicas; k++) {
+      size_t r = atTemp[k];
+      sweep(edges, scorers[r].get(), temps[k], &rngs[r], &scores[r]);
+    }
+
+    for (size_t r = 0; r < numReplicas; r++) {
+      if (scores[r] >= bestScore) continue;
+
+      // re-sync the accumulated score changes
+      scores[r] = _optScorer.getTotalScore(g, cfgs[r]);
+      if (scores[r] < bestScore) {
+        bestScore = scores[r];
+        bestCfg = cfgs[r];
+        lastImpr = rounds;
+      }
+    }
+
+    // exchange configurations of neighbouring temperatures, alternating
+    // between even and odd pairs
+    for (size_t k = rounds % 2; k + 1 < numReplicas; k += 2) {
+      double x = (1 / temps[k] - 1 / temps[k + 1]) *
+                 (scores[atTemp[k]] - scores[atTemp[k + 1]]);
+      if (x >= 0 || unif(rng()) < exp(x)) std::swap(atTemp[k], atTemp[k + 1]);
+    }
+
+    if (_cfg->ptTimeLimit >= 0 && T_STOP(1) > _cfg->ptTimeLimit * 1000) break;
+  }
+
+  LOGTO(DEBUG, std::cerr) << prefix(depth) << "(ParallelTemperingOptimizer) "
+                          << "Best score " << bestScore << " after " << rounds
+                          << " rounds with " << numReplicas << " replicas";
+
+  writeHierarch(&bestCfg, hc);
+  return T_STOP(1);
+}
+
+// _____________________________________________________________________________
+void ParallelTemperingOptimizer::sweep(const std::vector<OptEdge*>& edges,
+                                       SwapScorer* scorer, double temp,
+                                       std::mt19937* rng,
+                                       double* score) const {
+  std::uniform_real_distribution<double> unif(0, 1);
+
+  for (auto e : edges) {
+    size_t card = e->pl().getCardinality();
+    for (size_t p1 = 0; p1 < card; p1++) {
+      for (size_t p2 = p1 + 1; p2 < card; p2++) {
+        double d = scorer->delta(e, p1, p2);
+
+        if (d < 0 || (d > 0 && unif(*rng) < exp(-d / temp))) {
+          scorer->swap(e, p1, p2);
+          *score += d;
+        }
+      }
+    }
+  }
+}
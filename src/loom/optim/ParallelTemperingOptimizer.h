@@ -0,0 +1,44 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef LOOM_OPTIM_PARALLELTEMPERINGOPTIMIZER_H_
+#define LOOM_OPTIM_PARALLELTEMPERINGOPTIMIZER_H_
+
+#include <random>
+#include <vector>
+#include "loom/config/LoomConfig.h"
+#include "loom/optim/HillClimbOptimizer.h"
+#include "loom/optim/OptGraph.h"
+#include "loom/optim/Optimizer.h"
+#include "loom/optim/SwapScorer.h"
+#include "shared/rendergraph/OrderCfg.h"
+
+namespace loom {
+namespace optim {
+
+// Simulated annealing with several replicas at fixed temperatures on a
+// geometric ladder between --pt-temp-min and --pt-temp-max. Replicas are
+// swept in parallel, after each sweep configurations of neighbouring
+// temperatures are exchanged by the Metropolis criterion.
+class ParallelTemperingOptimizer : public HillClimbOptimizer {
+ public:
+  ParallelTemperingOptimizer(const config::Config* cfg,
+                             const shared::rendergraph::Penalties& pens,
+                             bool randomStart)
+      : HillClimbOptimizer(cfg, pens, randomStart){};
+
+  virtual double optimizeComp(OptGraph* og, const std::set<OptNode*>& g,
+                              shared::rendergraph::HierarOrderCfg* c,
+                              size_t depth, OptResStats& stats) const;
+
+ private:
+  // a single annealing sweep over all swaps of all edges at temperature
+  // temp, score is updated by the accepted changes
+  void sweep(const std::vector<OptEdge*>& edges, SwapScorer* scorer,
+             double temp, std::mt19937* rng, double* score) const;
+};
+}  // namespace optim
+}  // namespace loom
+
+#endif  // LOOM_OPTIM_PARALLELTEMPERINGOPTIMIZER_H_
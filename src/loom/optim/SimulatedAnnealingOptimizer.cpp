@@ -3,9 +3,11 @@
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
 #include <algorithm>
+#include <random>
 #include <unordered_map>
 #include "loom/optim/GreedyOptimizer.h"
 #include "loom/optim/SimulatedAnnealingOptimizer.h"
+#include "loom/optim/SwapScorer.h"
 #include "util/log/Log.h"
 
 using namespace loom;
@@ -24,6 +26,7 @@ double SimulatedAnnealingOptimizer::optimizeComp(OptGraph* og,
   T_START(1);
   UNUSED(depth);
   UNUSED(stats);
+  UNUSED(og);
   OptOrderCfg cur;
 
   // fixed order list of optim graph edges
@@ -42,6 +45,10 @@ double SimulatedAnnealingOptimizer::optimizeComp(OptGraph* og,
     greedy.getFlatConfig(g, &cur);
   }
 
+  SwapScorer scorer(_optScorer, g, &cur);
+
+  std::uniform_real_distribution<double> unif(0, 1);
+
   size_t iters = 0;
 
   size_t k = 0;
@@ -54,33 +61,21 @@ double SimulatedAnnealingOptimizer::optimizeComp(OptGraph* og,
     double temp = 1000.0 / iters;
 
     for (size_t i = 0; i < edges.size(); i++) {
-      double oldScore = getScore(og, edges[i], cur);
-
-      for (size_t p1 = 0; p1 < cur[edges[i]].size(); p1++) {
-        for (size_t p2 = p1; p2 < cur[edges[i]].size(); p2++) {
-          // switch p1 and p2
-          auto tmp = cur[edges[i]][p1];
-          cur[edges[i]][p1] = cur[edges[i]][p2];
-          cur[edges[i]][p2] = tmp;
-
-          double s = getScore(og, edges[i], cur);
+      for (size_t p1 = 0; p1 < cur.size(edges[i]); p1++) {
+        for (size_t p2 = p1; p2 < cur.size(edges[i]); p2++) {
+          double d = scorer.delta(edges[i], p1, p2);
 
-          double r = rand() / (RAND_MAX + 1.0);
-          double e = exp(-(1.0 * (s - oldScore)) / temp);
+          double r = unif(rng());
+          double e = exp(-(1.0 * d) / temp);
 
-          if (s < oldScore) {
-            // found a better solution, keep it, update score
-            oldScore = s;
+          if (d < 0) {
+            // found a better solution, keep it
+            scorer.swap(edges[i], p1, p2);
             k = iters;
-          } else if (s != oldScore && e > r) {
-            // keep solution, despite not bringing any local gain, update score
-            oldScore = s;
+          } else if (d != 0 && e > r) {
+            // keep solution, despite not bringing any local gain
+            scorer.swap(edges[i], p1, p2);
             k = iters;
-          } else {
-            // switch back
-            tmp = cur[edges[i]][p1];
-            cur[edges[i]][p1] = cur[edges[i]][p2];
-            cur[edges[i]][p2] = tmp;
           }
         }
       }
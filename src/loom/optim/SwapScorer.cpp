@@ -0,0 +1,257 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <limits>
+#include "loom/optim/SwapScorer.h"
+#include "shared/linegraph/Line.h"
+
+using loom::optim::OptEdge;
+using loom::optim::OptNode;
+using loom::optim::SwapScorer;
+using shared::linegraph::Line;
+
+const static size_t NO_ND = std::numeric_limits<size_t>::max();
+
+// _____________________________________________________________________________
+SwapScorer::SwapScorer(const OptGraphScorer& scorer,
+                       const std::set<OptNode*>& g, OptOrderCfg* c)
+    : _c(c) {
+  for (auto n : g) {
+    for (auto e : n->getAdjList()) {
+      if (e->getFrom() != n) continue;
+      auto& ec = _edges[e];
+      size_t card = c->size(e);
+      ec.ord.resize(card);
+      ec.pos.resize(card);
+      for (size_t i = 0; i < card; i++) ec.ord[i] = ec.pos[i] = i;
+      ec.nd[0] = ec.nd[1] = NO_ND;
+      ec.ndIdx[0] = ec.ndIdx[1] = 0;
+    }
+  }
+
+  for (auto n : g) {
+    // nodes without a penalty never contribute to the score
+    if (!n->pl().node || n->getDeg() < 2) continue;
+
+    NodeCache nd;
+    nd.penSame = scorer.getCrossingPenSameSeg(n);
+    nd.penDiff = scorer.getCrossingPenDiffSeg(n);
+    nd.penSep = scorer.getSeparationPen(n);
+    nd.diffSeg = n->getDeg() > 2;
+
+    std::vector<OptEdge*> adj;
+    for (auto e : n->getAdjList()) {
+      auto& ec = _edges.at(e);
+      size_t side = e->getFrom() == n ? 0 : 1;
+      ec.nd[side] = _nds.size();
+      ec.ndIdx[side] = adj.size();
+
+      adj.push_back(e);
+      nd.edges.push_back(&ec);
+      nd.rev.push_back((e->getFrom() != n) ^ e->pl().lnEdgParts.front().dir);
+    }
+
+    size_t deg = adj.size();
+    nd.conn.resize(deg, std::vector<std::vector<int32_t>>(deg));
+    nd.clockw.resize(deg, std::vector<size_t>(deg, 0));
+
+    for (size_t i = 0; i < deg; i++) {
+      const auto& clockw = OptGraph::clockwEdges(adj[i], n);
+      for (size_t r = 0; r < clockw.size(); r++) {
+        size_t j = std::find(adj.begin(), adj.end(), clockw[r]) - adj.begin();
+        if (j < deg) nd.clockw[i][j] = r;
+      }
+    }
+
+    for (size_t j = 0; j < deg; j++) {
+      for (size_t i = 0; i < deg; i++) {
+        if (i == j) continue;
+        auto& conn = nd.conn[i][j];
+        conn.resize(c->size(adj[i]), -1);
+        for (size_t l = 0; l < conn.size(); l++) {
+          const auto* line =
+              adj[i]->pl().getLines()[c->lineIdx(adj[i], l)].line;
+          int lIdx = adj[j]->pl().getLineIdx(line);
+          if (lIdx < 0) continue;
+          if (connects(n, adj[i], adj[j], line)) conn[l] = c->pos(adj[j], lIdx);
+        }
+      }
+    }
+
+    _nds.push_back(nd);
+  }
+}
+
+// _____________________________________________________________________________
+bool SwapScorer::connects(const OptNode* n, const OptEdge* ea,
+                          const OptEdge* eb, const Line* l) {
+  const auto* eaLo = ea->pl().getLineOcc(l);
+  const auto* ebLo = eb->pl().getLineOcc(l);
+  if (!eaLo || !ebLo) return false;
+
+  // see OptGraphScorer::getNumCrossSeps()
+  const auto* lnNd = n->pl().node;
+  return (eaLo->dir == 0 || ebLo->dir == 0 ||
+          (eaLo->dir == lnNd) != (ebLo->dir == lnNd)) &&
+         lnNd->pl().connOccurs(l, OptGraph::getAdjEdg(ea, n),
+                               OptGraph::getAdjEdg(eb, n));
+}
+
+// _____________________________________________________________________________
+double SwapScorer::delta(const OptEdge* e, size_t p1, size_t p2) const {
+  if (p1 == p2) return 0;
+  if (p1 > p2) std::swap(p1, p2);
+
+  const auto& ec = _edges.find(e)->second;
+
+  double ret = 0;
+  for (size_t side = 0; side < 2; side++) {
+    if (ec.nd[side] == NO_ND) continue;
+    ret += delta(_nds[ec.nd[side]], ec.ndIdx[side], ec, p1, p2);
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+double SwapScorer::delta(const NodeCache& nd, size_t i, const EdgeCache& ec,
+                         size_t p1, size_t p2) const {
+  int64_t same = 0, diff = 0;
+
+  size_t a = ec.ord[p1];
+  size_t b = ec.ord[p2];
+
+  // the line pairs of edge i whose relative order changes: a with everything
+  // up to b, and everything between a and b with b
+  for (size_t p = p1 + 1; p <= p2; p++) {
+    pairDelta(nd, i, a, ec.ord[p], &same, &diff);
+    if (p < p2) pairDelta(nd, i, ec.ord[p], b, &same, &diff);
+  }
+
+  int64_t sep = nd.penSep > 0 ? sepDelta(nd, i, ec, p1, p2) : 0;
+
+  return same * nd.penSame + diff * nd.penDiff + sep * nd.penSep;
+}
+
+// _____________________________________________________________________________
+void SwapScorer::pairDelta(const NodeCache& nd, size_t i, size_t u, size_t v,
+                           int64_t* same, int64_t* diff) const {
+  const auto& conn = nd.conn[i];
+
+  // same segment crossings, counted once per (unordered) edge pair, as
+  // line continuations are symmetric
+  for (size_t j = 0; j < nd.edges.size(); j++) {
+    if (j == i) continue;
+    int32_t cu = conn[j][u];
+    int32_t cv = conn[j][v];
+    if (cu < 0 || cv < 0) continue;
+
+    const auto& pos = nd.edges[j]->pos;
+    bool rev = !(nd.rev[i] ^ nd.rev[j]);
+    bool crossed = (pos[cu] < pos[cv]) == rev;
+    *same += crossed ? -1 : 1;
+  }
+
+  if (!nd.diffSeg) return;
+
+  // different segment crossings, u and v continue into different edges,
+  // counted by whether u's edge comes before v's edge in clockwise order
+  int64_t uFirst = 0, vFirst = 0;
+  for (size_t ju = 0; ju < nd.edges.size(); ju++) {
+    if (ju == i || conn[ju][u] < 0) continue;
+    for (size_t jv = 0; jv < nd.edges.size(); jv++) {
+      if (jv == i || jv == ju || conn[jv][v] < 0) continue;
+      if (nd.clockw[i][ju] < nd.clockw[i][jv]) {
+        uFirst++;
+      } else {
+        vFirst++;
+      }
+    }
+  }
+
+  *diff += nd.rev[i] ? vFirst - uFirst : uFirst - vFirst;
+}
+
+// _____________________________________________________________________________
+int64_t SwapScorer::sepDelta(const NodeCache& nd, size_t i,
+                             const EdgeCache& ec, size_t p1,
+                             size_t p2) const {
+  int64_t ret = 0;
+
+  size_t a = ec.ord[p1];
+  size_t b = ec.ord[p2];
+
+  // line at position p of edge i after the swap
+  auto lineAfter = [&](size_t p) -> size_t {
+    if (p == p1) return b;
+    if (p == p2) return a;
+    return ec.ord[p];
+  };
+
+  // position of line l of edge i after the swap
+  auto posAfter = [&](size_t l) -> size_t {
+    if (l == a) return p2;
+    if (l == b) return p1;
+    return ec.pos[l];
+  };
+
+  auto sep = [](size_t pa, size_t pb) -> int64_t {
+    return pa > pb + 1 || pb > pa + 1;
+  };
+
+  for (size_t j = 0; j < nd.edges.size(); j++) {
+    if (j == i) continue;
+    const auto& eb = *nd.edges[j];
+    const auto& conn = nd.conn[i][j];
+    const auto& connB = nd.conn[j][i];
+
+    // separations along edge i, only the neighbours of p1 and p2 change
+    size_t ps[4] = {p1, p1 + 1, p2, p2 + 1};
+    for (size_t k = 0; k < 4; k++) {
+      size_t p = ps[k];
+      if (p == 0 || p >= ec.ord.size() || (k == 2 && p == p1 + 1)) continue;
+
+      int32_t u = conn[ec.ord[p - 1]];
+      int32_t v = conn[ec.ord[p]];
+      if (u >= 0 && v >= 0) ret -= sep(eb.pos[u], eb.pos[v]);
+
+      u = conn[lineAfter(p - 1)];
+      v = conn[lineAfter(p)];
+      if (u >= 0 && v >= 0) ret += sep(eb.pos[u], eb.pos[v]);
+    }
+
+    // separations along edge j, only the neighbours of a and b change
+    size_t qs[4];
+    size_t numQs = 0;
+    for (size_t l : {a, b}) {
+      if (conn[l] < 0) continue;
+      size_t q = eb.pos[conn[l]];
+      if (q > 0) qs[numQs++] = q;
+      if (q + 1 < eb.ord.size()) qs[numQs++] = q + 1;
+    }
+
+    std::sort(qs, qs + numQs);
+    numQs = std::unique(qs, qs + numQs) - qs;
+
+    for (size_t k = 0; k < numQs; k++) {
+      int32_t u = connB[eb.ord[qs[k] - 1]];
+      int32_t v = connB[eb.ord[qs[k]]];
+      if (u < 0 || v < 0) continue;
+      ret += sep(posAfter(u), posAfter(v)) - sep(ec.pos[u], ec.pos[v]);
+    }
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+void SwapScorer::swap(const OptEdge* e, size_t p1, size_t p2) {
+  auto& ec = _edges.find(e)->second;
+
+  _c->swap(e, p1, p2);
+  std::swap(ec.ord[p1], ec.ord[p2]);
+  ec.pos[ec.ord[p1]] = p1;
+  ec.pos[ec.ord[p2]] = p2;
+}
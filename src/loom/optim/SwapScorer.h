@@ -0,0 +1,92 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef LOOM_OPTIM_SWAPSCORER_H_
+#define LOOM_OPTIM_SWAPSCORER_H_
+
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "loom/optim/OptGraph.h"
+#include "loom/optim/OptGraphScorer.h"
+
+namespace loom {
+namespace optim {
+
+// Incrementally scores swaps of two lines on a single edge of an optim graph
+// component. For each node, the line continuations between all pairs of
+// adjacent edges are cached, so the score change of a swap only looks at the
+// line pairs whose relative order actually changes. The score changes are
+// the same as those of OptGraphScorer::getTotalScore().
+class SwapScorer {
+ public:
+  // the ordering c must contain all edges of component g and is updated on
+  // swap()
+  SwapScorer(const OptGraphScorer& scorer, const std::set<OptNode*>& g,
+             OptOrderCfg* c);
+
+  // node caches point into the edge caches
+  SwapScorer(const SwapScorer&) = delete;
+  SwapScorer& operator=(const SwapScorer&) = delete;
+
+  // change of the total score if the lines at positions p1 and p2 of edge e
+  // were swapped
+  double delta(const OptEdge* e, size_t p1, size_t p2) const;
+
+  // swap the lines at positions p1 and p2 of edge e
+  void swap(const OptEdge* e, size_t p1, size_t p2);
+
+ private:
+  // current ordering of an edge, lines are identified by their position in
+  // the initial ordering
+  struct EdgeCache {
+    std::vector<size_t> ord;  // position -> line
+    std::vector<size_t> pos;  // line -> position
+
+    // the scored nodes at both ends of the edge, and the index of the edge
+    // there
+    size_t nd[2];
+    size_t ndIdx[2];
+  };
+
+  struct NodeCache {
+    double penSame, penDiff, penSep;
+    bool diffSeg;
+
+    std::vector<const EdgeCache*> edges;
+
+    // whether the ordering of edge i is reversed at this node
+    std::vector<bool> rev;
+
+    // conn[i][j][l] is the line in edge j which line l of edge i continues
+    // in and may cross or separate with, or -1
+    std::vector<std::vector<std::vector<int32_t>>> conn;
+
+    // clockw[i][j] is the position of edge j in the clockwise edge ordering
+    // starting at edge i
+    std::vector<std::vector<size_t>> clockw;
+  };
+
+  double delta(const NodeCache& nd, size_t i, const EdgeCache& ec, size_t p1,
+               size_t p2) const;
+
+  // score changes of flipping lines u and v of edge i, with u before v
+  void pairDelta(const NodeCache& nd, size_t i, size_t u, size_t v,
+                 int64_t* same, int64_t* diff) const;
+
+  int64_t sepDelta(const NodeCache& nd, size_t i, const EdgeCache& ec,
+                   size_t p1, size_t p2) const;
+
+  static bool connects(const OptNode* n, const OptEdge* ea, const OptEdge* eb,
+                       const shared::linegraph::Line* l);
+
+  OptOrderCfg* _c;
+  std::unordered_map<const OptEdge*, EdgeCache> _edges;
+  std::vector<NodeCache> _nds;
+};
+}  // namespace optim
+}  // namespace loom
+
+#endif  // LOOM_OPTIM_SWAPSCORER_H_
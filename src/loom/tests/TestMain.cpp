@@ -2,12 +2,29 @@
 // Author: Patrick Brosi
 //
 
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
 #include <vector>
 
 #include "loom/config/LoomConfig.h"
 #include "loom/optim/CombOptimizer.h"
+#include "loom/optim/OptGraph.h"
+#include "loom/optim/OptGraphScorer.h"
+#include "loom/optim/SwapScorer.h"
 #include "shared/optim/ILPSolvProv.h"
 #include "shared/rendergraph/RenderGraph.h"
+#include "util/graph/Algorithm.h"
+
+using loom::optim::OptEdge;
+using loom::optim::OptGraph;
+using loom::optim::OptGraphScorer;
+using loom::optim::OptNode;
+using loom::optim::OptOrderCfg;
+using loom::optim::SwapScorer;
+using util::approx;
 
 struct FileTest {
   std::string fname;
@@ -418,11 +435,205 @@ static const std::vector<FileTest> fileTests(
 
     });
 
+struct SwapCoverage {
+  size_t degTwo, degMore, rev, notRev;
+};
+
+// _____________________________________________________________________________
+void testSwapScorer(const std::string& path,
+                    const shared::rendergraph::Penalties& pens,
+                    SwapCoverage* cov) {
+  shared::rendergraph::RenderGraph rg(5, 1, 5);
+
+  std::ifstream input;
+  input.open(path);
+  rg.readFromJson(&input, true);
+
+  OptGraphScorer scorer(pens);
+  OptGraph g(&scorer);
+  g.build(&rg);
+
+  std::mt19937 rng(42);
+
+  for (const auto& comp : util::graph::Algorithm::connectedComponents(g)) {
+    OptGraph::writeEdgIdxs(comp);
+    OptOrderCfg cfg(comp);
+    std::vector<OptEdge*> edges;
+
+    for (auto e : cfg.getEdgs()) {
+      std::shuffle(cfg.begin(e), cfg.end(e), rng);
+      cfg.update(e);
+      if (e->pl().getCardinality() > 1) edges.push_back(e);
+    }
+
+    if (edges.empty()) continue;
+
+    SwapScorer ss(scorer, comp, &cfg);
+
+    for (size_t i = 0; i < 200; i++) {
+      auto e = edges[rng() % edges.size()];
+      size_t p1 = rng() % cfg.size(e);
+      size_t p2 = rng() % cfg.size(e);
+
+      if (p1 == p2) continue;
+
+      for (auto n : {e->getFrom(), e->getTo()}) {
+        if (!n->pl().node || n->getDeg() < 2) continue;
+        if (n->getDeg() == 2) {
+          cov->degTwo++;
+        } else {
+          cov->degMore++;
+        }
+        if ((e->getFrom() != n) ^ e->pl().lnEdgParts.front().dir) {
+          cov->rev++;
+        } else {
+          cov->notRev++;
+        }
+      }
+
+      double before = scorer.getTotalScore(comp, cfg);
+      double d = ss.delta(e, p1, p2);
+      ss.swap(e, p1, p2);
+      double after = scorer.getTotalScore(comp, cfg);
+
+      TEST(d, ==, approx(after - before));
+    }
+  }
+}
+
+// _____________________________________________________________________________
+void testSwapScorer() {
+  shared::rendergraph::Penalties pens{1, 0, 1, 1, 0, 1, 1, 0, false, false};
+
+  shared::rendergraph::Penalties sepPens = pens;
+  sepPens.inStatSplitPenDegTwo = 1;
+  sepPens.inStatSplitPen = 1;
+  sepPens.splitPen = 1;
+
+  shared::rendergraph::Penalties adjPens = pens;
+  adjPens.diffSegCrossPen = 100;
+  adjPens.inStatCrossPenDiffSeg = 200;
+  adjPens.inStatCrossPenSameSeg = 5;
+  adjPens.inStatCrossPenDegTwo = 5;
+  adjPens.inStatSplitPenDegTwo = 300;
+  adjPens.inStatSplitPen = 300;
+  adjPens.splitPen = 500;
+  adjPens.crossAdjPen = true;
+  adjPens.splitAdjPen = true;
+
+  std::vector<std::string> paths;
+  for (const auto& test : fileTests) paths.push_back(test.fname);
+  paths.push_back("../src/loom/tests/datasets/freiburg-tram.json");
+
+  for (const auto& p : {pens, sepPens, adjPens}) {
+    SwapCoverage cov{0, 0, 0, 0};
+    for (const auto& path : paths) testSwapScorer(path, p, &cov);
+
+    TEST(cov.degTwo, >, 0);
+    TEST(cov.degMore, >, 0);
+    TEST(cov.rev, >, 0);
+    TEST(cov.notRev, >, 0);
+  }
+}
+
+// _____________________________________________________________________________
+double bruteForceScore(shared::rendergraph::RenderGraph* rg,
+                       const shared::rendergraph::Penalties& pens) {
+  OptGraphScorer scorer(pens);
+  OptGraph g(&scorer);
+  g.build(rg);
+
+  double ret = 0;
+
+  for (const auto& comp : util::graph::Algorithm::connectedComponents(g)) {
+    // orderings start sorted
+    OptGraph::writeEdgIdxs(comp);
+    OptOrderCfg cfg(comp);
+    const auto& edges = cfg.getEdgs();
+
+    // enumerate the full Cartesian product of the edge orderings
+    double best = std::numeric_limits<double>::infinity();
+    while (true) {
+      best = std::min(best, scorer.getTotalScore(comp, cfg));
+
+      size_t i = 0;
+      for (; i < edges.size(); i++) {
+        if (cfg.nextPermutation(edges[i])) break;
+      }
+      if (i == edges.size()) break;
+    }
+
+    ret += best;
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+void testBranchAndBound() {
+  loom::config::Config cfg;
+  cfg.untangleGraph = false;
+  cfg.pruneGraph = false;
+  cfg.optimRuns = 1;
+
+  shared::rendergraph::Penalties pens{1, 0, 1, 1, 0, 1, 1, 0, false, false};
+
+  shared::rendergraph::Penalties sepPens = pens;
+  sepPens.inStatSplitPenDegTwo = 1;
+  sepPens.inStatSplitPen = 1;
+  sepPens.splitPen = 1;
+
+  shared::rendergraph::Penalties adjPens = pens;
+  adjPens.diffSegCrossPen = 100;
+  adjPens.inStatCrossPenDiffSeg = 200;
+  adjPens.inStatCrossPenSameSeg = 5;
+  adjPens.inStatCrossPenDegTwo = 5;
+  adjPens.inStatSplitPenDegTwo = 300;
+  adjPens.inStatSplitPen = 300;
+  adjPens.splitPen = 500;
+  adjPens.crossAdjPen = true;
+  adjPens.splitAdjPen = true;
+
+  for (const auto& p : {pens, sepPens, adjPens}) {
+    size_t tested = 0;
+
+    for (const auto& test : fileTests) {
+      shared::rendergraph::RenderGraph g(5, 1, 5);
+
+      std::ifstream input;
+      input.open(test.fname);
+      g.readFromJson(&input, true);
+
+      if (g.searchSpaceSize() > 50000) continue;
+
+      double expected = bruteForceScore(&g, p);
+
+      loom::optim::ExhaustiveOptimizer exhausOptim(&cfg, p);
+      auto res = exhausOptim.optimize(&g);
+
+      TEST(res.score, ==, approx(expected));
+      tested++;
+
+      // once the node budget is exhausted, the best ordering found so far
+      // is used
+      loom::config::Config limCfg = cfg;
+      limCfg.exhausIterLimit = 1;
+      loom::optim::ExhaustiveOptimizer limOptim(&limCfg, p);
+      TEST(limOptim.optimize(&g).score + 0.0001, >=, expected);
+    }
+
+    TEST(tested, >, 0);
+  }
+}
+
 // _____________________________________________________________________________
 int main(int argc, char** argv) {
   UNUSED(argc);
   UNUSED(argv);
 
+  testSwapScorer();
+  testBranchAndBound();
+
   loom::config::Config baseCfg;
   baseCfg.untangleGraph = false;
   baseCfg.pruneGraph = false;
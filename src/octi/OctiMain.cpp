@@ -5,14 +5,20 @@
 #include <stdio.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <set>
+#include <sstream>
 
 #include "3rdparty/json.hpp"
 #include "octi/Enlarger.h"
 #include "octi/Octilinearizer.h"
 #include "octi/basegraph/BaseGraph.h"
+#include "octi/cache/CacheUtil.h"
 #include "octi/combgraph/CombGraph.h"
 #include "octi/config/ConfigReader.h"
 #include "shared/linegraph/LineGraph.h"
@@ -26,14 +32,18 @@
 #include <omp.h>
 #else
 #define omp_get_num_procs() 1
+#define omp_get_max_threads() 1
+#define omp_set_max_active_levels(l)
 #endif
 
 using std::string;
 using namespace octi;
 
 using octi::Enlarger;
+using octi::HeurStats;
 using octi::Octilinearizer;
 using octi::basegraph::BaseGraph;
+using octi::cache::Fingerprint;
 using util::geo::dist;
 using util::geo::DPolygon;
 
@@ -52,6 +62,305 @@ struct TotalScore {
   double timeMs = 0;
 };
 
+// results of a single input component
+struct CompResult {
+  util::json::Array jsonScores;
+  std::vector<LineGraph*> resultGraphs;
+  std::vector<BaseGraph*> resultGridGraphs;
+  TotalScore totScore;
+  std::string error;
+};
+
+// statistics of a single drawn component, also stored with cached
+// components
+struct CompStats {
+  Score score;
+  octi::ilp::ILPStats ilpstats;
+  HeurStats heurStats;
+
+  size_t gridgraphNumNds = 0;
+  size_t gridgraphNumEdgs = 0;
+  size_t combgraphNumNds = 0;
+  size_t combgraphNumEdgs = 0;
+  size_t inputgraphNumNds = 0;
+  size_t inputgraphNumEdgs = 0;
+  size_t inputgraphMaxDeg = 0;
+
+  // in meters and square meters
+  double avgNodeDist = 0;
+  double area = 0;
+
+  // time it took to draw the component, also for cached components
+  double timeMs = 0;
+};
+
+// grid nodes and directed grid edges per cell of an octilinear grid: a
+// center node with 8 ports, 16 sink edges between the center and its ports,
+// 56 bend edges between the ports and 8 edges to the ports of the
+// neighbouring cells
+const static size_t NDS_PER_CELL = 9;
+const static size_t EDGS_PER_CELL = 16 + 56 + 8;
+
+// every node and edge is a separate heap allocation, nodes are kept in the
+// graph's node set (one tree node of about 48 bytes each) and in the grid's
+// id index, edges are kept in the adjacency lists of both their nodes
+const static size_t ALLOC_OVERHEAD = 16;
+const static size_t BYTES_PER_CELL =
+    NDS_PER_CELL *
+        (sizeof(GridNode) + ALLOC_OVERHEAD + 48 + sizeof(GridNode*)) +
+    EDGS_PER_CELL *
+        (sizeof(GridEdge) + ALLOC_OVERHEAD + 2 * sizeof(GridEdge*));
+
+// limits the estimated memory of components drawn at the same time, a
+// component is always admitted if nothing else is running
+class MemBudget {
+ public:
+  explicit MemBudget(size_t bytes) : _max(bytes), _used(0), _running(0) {}
+
+  void acquire(size_t bytes) {
+    std::unique_lock<std::mutex> lock(_m);
+    _cv.wait(lock, [&] {
+      return _max == 0 || _running == 0 || _used + bytes <= _max;
+    });
+    _used += bytes;
+    _running++;
+  }
+
+  void release(size_t bytes) {
+    {
+      std::lock_guard<std::mutex> lock(_m);
+      _used -= bytes;
+      _running--;
+    }
+    _cv.notify_all();
+  }
+
+ private:
+  size_t _max, _used, _running;
+  std::mutex _m;
+  std::condition_variable _cv;
+};
+
+// _____________________________________________________________________________
+uint64_t compFingerprint(const LineGraph& tg, double gridSize,
+                         const config::Config& cfg) {
+  // nodes and edges are hashed independently, so the fingerprint does not
+  // depend on the order in which the input was read
+  std::vector<uint64_t> parts;
+
+  for (auto nd : tg.getNds()) {
+    Fingerprint fn;
+    fn.add(*nd->pl().getGeom());
+    for (const auto& st : nd->pl().stops()) {
+      fn.add(st.id);
+      fn.add(st.name);
+    }
+    fn.add(static_cast<int64_t>(nd->pl().numConnExcs()));
+    parts.push_back(fn.get());
+
+    for (auto e : nd->getAdjList()) {
+      if (e->getFrom() != nd) continue;
+      Fingerprint fe;
+      for (const auto& p : *e->pl().getGeom()) fe.add(p);
+
+      std::vector<uint64_t> lines;
+      for (const auto& lo : e->pl().getLines()) {
+        Fingerprint fl;
+        fl.add(lo.line->id());
+        fl.add(lo.line->label());
+        fl.add(lo.line->color());
+        fl.add(static_cast<int64_t>(
+            lo.direction == 0 ? 0 : lo.direction == e->getFrom() ? 1 : 2));
+        lines.push_back(fl.get());
+      }
+      fe.add(&lines);
+      parts.push_back(fe.get());
+    }
+  }
+
+  Fingerprint f;
+
+  // bump if the cached format or the drawing itself changes
+  f.add(std::string("octi-comp-1"));
+  f.add(&parts);
+
+  // everything the drawing depends on, but not settings which only affect
+  // how fast it is computed
+  f.add(cfg.optMode);
+  f.add(static_cast<int64_t>(cfg.baseGraphType));
+  f.add(static_cast<int64_t>(cfg.orderMethod));
+  f.add(gridSize);
+  f.add(cfg.borderRad);
+  f.add(cfg.maxGrDist);
+  f.add(cfg.enfGeoPen);
+  f.add(static_cast<int64_t>(cfg.hananIters));
+  f.add(static_cast<int64_t>(cfg.deg2Heur));
+  f.add(static_cast<int64_t>(cfg.restrLocSearch));
+  f.add(static_cast<int64_t>(cfg.multiLocSearch));
+  f.add(static_cast<int64_t>(cfg.heurLocSearchIters));
+  f.add(static_cast<int64_t>(cfg.abortAfter));
+  f.add(static_cast<int64_t>(cfg.coarseLevels));
+  f.add(static_cast<int64_t>(cfg.coarseCorridor));
+  f.add(cfg.ilpSolver);
+  f.add(static_cast<int64_t>(cfg.ilpNoSolve));
+  f.add(static_cast<int64_t>(cfg.ilpTimeLimit));
+  f.add(cfg.ilpCorridor);
+  f.add(static_cast<int64_t>(cfg.ilpCorridorIters));
+
+  double pens[] = {cfg.pens.p_0,          cfg.pens.p_45,
+                   cfg.pens.p_90,         cfg.pens.p_135,
+                   cfg.pens.verticalPen,  cfg.pens.horizontalPen,
+                   cfg.pens.diagonalPen,  cfg.pens.densityPen,
+                   cfg.pens.ndMovePen};
+  f.add(pens, sizeof(pens));
+
+  for (const auto& obst : cfg.obstacles) {
+    for (const auto& p : obst.getOuter()) f.add(p);
+  }
+
+  std::vector<uint64_t> prev;
+  for (const auto& st : cfg.prevLayout) {
+    Fingerprint fs;
+    fs.add(st.first);
+    fs.add(st.second);
+    prev.push_back(fs.get());
+  }
+  f.add(&prev);
+
+  return f.get();
+}
+
+// _____________________________________________________________________________
+std::string compCachePath(const config::Config& cfg, uint64_t key) {
+  std::stringstream ss;
+  ss << cfg.resultCacheDir << "/" << std::hex << key << ".json";
+  return ss.str();
+}
+
+// _____________________________________________________________________________
+util::json::Dict compStatsToJson(const CompStats& st) {
+  util::json::Array busy, tasks, trajectory;
+  for (auto t : st.heurStats.threadBusyMs) busy.push_back(t);
+  for (auto t : st.heurStats.threadTasks) tasks.push_back(t);
+  for (const auto& p : st.heurStats.scoreTrajectory) {
+    trajectory.push_back(util::json::Array{p.first, p.second});
+  }
+
+  return util::json::Dict{
+      {"score", util::json::Dict{{"bend", st.score.bend},
+                                 {"move", st.score.move},
+                                 {"hop", st.score.hop},
+                                 {"dense", st.score.dense},
+                                 {"full", st.score.full},
+                                 {"violations",
+                                  util::json::Int(st.score.violations)},
+                                 {"iters", st.score.iters}}},
+      {"ilp", util::json::Dict{{"score", st.ilpstats.score},
+                               {"time", st.ilpstats.time},
+                               {"rows", st.ilpstats.rows},
+                               {"cols", st.ilpstats.cols},
+                               {"optimal",
+                                util::json::Bool{st.ilpstats.optimal}}}},
+      {"heur", util::json::Dict{{"threads", st.heurStats.threads},
+                                {"wall-ms", st.heurStats.wallMs},
+                                {"thread-busy-ms", busy},
+                                {"thread-tasks", tasks},
+                                {"iters", st.heurStats.iters},
+                                {"timed-out",
+                                 util::json::Bool{st.heurStats.timedOut}},
+                                {"score-trajectory", trajectory}}},
+      {"gridgraph-nodes", st.gridgraphNumNds},
+      {"gridgraph-edges", st.gridgraphNumEdgs},
+      {"combgraph-nodes", st.combgraphNumNds},
+      {"combgraph-edges", st.combgraphNumEdgs},
+      {"input-graph-nodes", st.inputgraphNumNds},
+      {"input-graph-edges", st.inputgraphNumEdgs},
+      {"input-graph-max-deg", st.inputgraphMaxDeg},
+      {"avg-node-dist", st.avgNodeDist},
+      {"area", st.area},
+      {"time-ms", st.timeMs}};
+}
+
+// _____________________________________________________________________________
+CompStats compStatsFromJson(const nlohmann::json& j) {
+  CompStats st;
+
+  const auto& sc = j.at("score");
+  st.score.bend = sc.at("bend").get<double>();
+  st.score.move = sc.at("move").get<double>();
+  st.score.hop = sc.at("hop").get<double>();
+  st.score.dense = sc.at("dense").get<double>();
+  st.score.full = sc.at("full").get<double>();
+  st.score.violations = sc.at("violations").get<uint64_t>();
+  st.score.iters = sc.at("iters").get<size_t>();
+
+  const auto& ilp = j.at("ilp");
+  st.ilpstats.score = ilp.at("score").get<double>();
+  st.ilpstats.time = ilp.at("time").get<double>();
+  st.ilpstats.rows = ilp.at("rows").get<size_t>();
+  st.ilpstats.cols = ilp.at("cols").get<size_t>();
+  st.ilpstats.optimal = ilp.at("optimal").get<bool>();
+
+  const auto& heur = j.at("heur");
+  st.heurStats.threads = heur.at("threads").get<size_t>();
+  st.heurStats.wallMs = heur.at("wall-ms").get<double>();
+  st.heurStats.threadBusyMs =
+      heur.at("thread-busy-ms").get<std::vector<double>>();
+  st.heurStats.threadTasks = heur.at("thread-tasks").get<std::vector<size_t>>();
+  st.heurStats.iters = heur.at("iters").get<size_t>();
+  st.heurStats.timedOut = heur.at("timed-out").get<bool>();
+  st.heurStats.scoreTrajectory =
+      heur.at("score-trajectory")
+          .get<std::vector<std::pair<double, double>>>();
+
+  st.gridgraphNumNds = j.at("gridgraph-nodes").get<size_t>();
+  st.gridgraphNumEdgs = j.at("gridgraph-edges").get<size_t>();
+  st.combgraphNumNds = j.at("combgraph-nodes").get<size_t>();
+  st.combgraphNumEdgs = j.at("combgraph-edges").get<size_t>();
+  st.inputgraphNumNds = j.at("input-graph-nodes").get<size_t>();
+  st.inputgraphNumEdgs = j.at("input-graph-edges").get<size_t>();
+  st.inputgraphMaxDeg = j.at("input-graph-max-deg").get<size_t>();
+  st.avgNodeDist = j.at("avg-node-dist").get<double>();
+  st.area = j.at("area").get<double>();
+  st.timeMs = j.at("time-ms").get<double>();
+
+  return st;
+}
+
+// _____________________________________________________________________________
+bool readCachedComp(const std::string& path, LineGraph* res, CompStats* st) {
+  std::ifstream in(path);
+  if (!in.good()) return false;
+
+  // read into a separate graph, res stays empty if the cache is unusable
+  LineGraph cached;
+
+  try {
+    cached.readFromJson(&in, true);
+    *st = compStatsFromJson(cached.getGraphProps().at("octi-comp-stats"));
+  } catch (const std::exception& e) {
+    LOGTO(WARN, std::cerr) << "Could not read cached component " << path
+                           << ": " << e.what();
+    return false;
+  }
+
+  *res = std::move(cached);
+  return true;
+}
+
+// _____________________________________________________________________________
+void writeCachedComp(const std::string& path, const LineGraph& res,
+                     const CompStats& st) {
+  bool ok = octi::cache::writeAtomic(path, [&](std::ostream* out) {
+    util::geo::output::GeoGraphJsonOutput gout;
+    gout.print(res, *out, util::json::Dict{{"octi-comp-stats",
+                                            compStatsToJson(st)}});
+    return true;
+  });
+
+  if (ok) LOGTO(DEBUG, std::cerr) << "Wrote component to " << path;
+}
+
 // _____________________________________________________________________________
 double avgStatDist(const LineGraph& g) {
   double avg = 0;
@@ -69,6 +378,268 @@ double avgStatDist(const LineGraph& g) {
   return avg;
 }
 
+// _____________________________________________________________________________
+double gridSizeFor(double avgDist, const config::Config& cfg) {
+  if (util::trim(cfg.gridSize).back() == '%') {
+    double perc = atof(cfg.gridSize.c_str()) / 100;
+    return avgDist * perc;
+  }
+  return atof(cfg.gridSize.c_str());
+}
+
+// _____________________________________________________________________________
+size_t estMemUsage(const LineGraph& tg, double avgDist,
+                   const config::Config& cfg) {
+  double gridSize = gridSizeFor(avgDist, cfg);
+  auto box = util::geo::pad(tg.getBBox(), gridSize + 1);
+  double w = box.getUpperRight().getX() - box.getLowerLeft().getX();
+  double h = box.getUpperRight().getY() - box.getLowerLeft().getY();
+  double cells = (w / gridSize + 1) * (h / gridSize + 1);
+
+  // 9 nodes per cell, one float distance per node and landmark
+  return cells * (BYTES_PER_CELL + cfg.altLandmarks * 9 * sizeof(float));
+}
+
+// _____________________________________________________________________________
+void mergeScore(TotalScore* a, const TotalScore& b) {
+  a->score = a->score + b.score;
+  a->ilpstats = a->ilpstats + b.ilpstats;
+  a->gridgraphNumNds += b.gridgraphNumNds;
+  a->gridgraphNumEdgs += b.gridgraphNumEdgs;
+  a->combgraphNumNds += b.combgraphNumNds;
+  a->combgraphNumEdgs += b.combgraphNumEdgs;
+  a->inputgraphNumNds += b.inputgraphNumNds;
+  a->inputgraphNumEdgs += b.inputgraphNumEdgs;
+  a->inputgraphMaxDeg = std::max(a->inputgraphMaxDeg, b.inputgraphMaxDeg);
+  a->numNoEmbeddingFound += b.numNoEmbeddingFound;
+  a->timeMs += b.timeMs;
+}
+
+// _____________________________________________________________________________
+void addCompStats(const CompStats& st, bool cacheHit,
+                  const config::Config& cfg, util::json::Array* jsonScores,
+                  TotalScore* totScore) {
+  const Score& sc = st.score;
+
+  // total score
+  totScore->score = totScore->score + sc;
+  totScore->ilpstats = totScore->ilpstats + st.ilpstats;
+
+  totScore->gridgraphNumNds += st.gridgraphNumNds;
+  totScore->gridgraphNumEdgs += st.gridgraphNumEdgs;
+  totScore->combgraphNumNds += st.combgraphNumNds;
+  totScore->combgraphNumEdgs += st.combgraphNumEdgs;
+  totScore->inputgraphNumNds += st.inputgraphNumNds;
+  totScore->inputgraphNumEdgs += st.inputgraphNumEdgs;
+  totScore->inputgraphMaxDeg =
+      std::max(totScore->inputgraphMaxDeg, st.inputgraphMaxDeg);
+  totScore->timeMs += st.timeMs;
+
+  size_t maxRss = util::getPeakRSS();
+
+  // translate score to JSON
+  util::json::Dict jsonScore = util::json::Dict{
+      {"scores",
+       util::json::Dict{{"total-score", sc.full},
+                        {"topo-violations", util::json::Int(sc.violations)},
+                        {"density-score", sc.dense},
+                        {"bend-score", sc.bend},
+                        {"hop-score", sc.hop},
+                        {"move-score", sc.move}}},
+      {"pens",
+       util::json::Dict{
+           {"density-pen", cfg.pens.densityPen},
+           {"diag-pen", cfg.pens.diagonalPen},
+           {"hori-pen", cfg.pens.horizontalPen},
+           {"vert-pen", cfg.pens.verticalPen},
+           {"180-turn-pen", cfg.pens.p_0},
+           {"135-turn-pen", cfg.pens.p_135},
+           {"90-turn-pen", cfg.pens.p_90},
+           {"45-turn-pen", cfg.pens.p_45},
+       }},
+      {"gridgraph-size", util::json::Dict{{"nodes", st.gridgraphNumNds},
+                                          {"edges", st.gridgraphNumEdgs}}},
+      {"combgraph-size", util::json::Dict{{"nodes", st.combgraphNumNds},
+                                          {"edges", st.combgraphNumEdgs}}},
+      {"input-graph-size",
+       util::json::Dict{{"nodes", st.inputgraphNumNds},
+                        {"edges", st.inputgraphNumEdgs},
+                        {"max-deg", st.inputgraphMaxDeg}}},
+      {"input-graph-avg-node-dist", st.avgNodeDist},
+      {"area", st.area},
+      {"misc", util::json::Dict{{"method", cfg.optMode},
+                                {"deg2heur", cfg.deg2Heur},
+                                {"max-grid-dist", cfg.maxGrDist}}},
+      {"cache-hit", util::json::Bool{cacheHit}},
+      {"time-ms", st.timeMs},
+      {"iterations", sc.iters},
+      {"procs", omp_get_num_procs()},
+      {"peak-memory", util::readableSize(maxRss)},
+      {"peak-memory-bytes", maxRss},
+      {"timestamp", util::json::Int(std::time(0))}};
+
+  if (cfg.optMode == "ilp") {
+    jsonScore["ilp"] = util::json::Dict{
+        {"size", util::json::Dict{{"rows", st.ilpstats.rows},
+                                  {"cols", st.ilpstats.cols}}},
+        {"solve-time", st.ilpstats.time},
+        {"optimal", util::json::Bool{st.ilpstats.optimal}}};
+  }
+
+  if (cfg.optMode == "heur") {
+    const HeurStats& heurStats = st.heurStats;
+    util::json::Array busy, tasks, utilization, trajectory;
+    for (size_t i = 0; i < heurStats.threads; i++) {
+      busy.push_back(heurStats.threadBusyMs[i]);
+      tasks.push_back(heurStats.threadTasks[i]);
+      utilization.push_back(heurStats.wallMs > 0 ? heurStats.threadBusyMs[i] /
+                                                       heurStats.wallMs
+                                                 : 0);
+    }
+    for (const auto& p : heurStats.scoreTrajectory) {
+      trajectory.push_back(util::json::Array{p.first, p.second});
+    }
+    jsonScore["heur"] = util::json::Dict{
+        {"iterations", heurStats.iters},
+        {"timed-out", util::json::Bool{heurStats.timedOut}},
+        {"time-budget", cfg.heurTimeBudget},
+        {"score-trajectory", trajectory},
+        {"threads", heurStats.threads},
+        {"wall-time", heurStats.wallMs},
+        {"thread-busy-time", busy},
+        {"thread-tasks", tasks},
+        {"thread-utilization", utilization}};
+  }
+
+  jsonScores->push_back(jsonScore);
+}
+
+// writes a feature collection graph by graph, each feature directly into
+// the open "features" array. The statistics are written as a trailing
+// "properties" member once all features are written
+class FeatureStream {
+ public:
+  explicit FeatureStream(std::ostream* out) : _out(out), _wr(out) {
+    _wr.obj();
+    _wr.keyVal("type", "FeatureCollection");
+    _wr.key("features");
+    _wr.arr();
+  }
+
+  // the same features as GeoGraphJsonOutput::printLatLng()
+  template <typename N, typename E>
+  void print(const util::graph::Graph<N, E>& g) {
+    for (auto n : g.getNds()) {
+      if (!n->pl().getGeom()) continue;
+
+      util::json::Dict props{{"id", util::toString(n)}};
+      auto attrs = n->pl().getAttrs();
+      props.insert(attrs.begin(), attrs.end());
+
+      feature(*n->pl().getGeom(), props);
+    }
+
+    for (auto n : g.getNds()) {
+      for (auto e : n->getAdjListOut()) {
+        if (e->getFrom() != n) continue;
+
+        util::geo::DLine geom;
+        if (e->pl().getGeom() && e->pl().getGeom()->size()) {
+          geom = *e->pl().getGeom();
+        } else if (e->getFrom()->pl().getGeom() &&
+                   e->getTo()->pl().getGeom()) {
+          geom = {*e->getFrom()->pl().getGeom(), *e->getTo()->pl().getGeom()};
+        } else {
+          continue;
+        }
+
+        util::json::Dict props{{"from", util::toString(e->getFrom())},
+                               {"to", util::toString(e->getTo())},
+                               {"id", util::toString(e)}};
+        auto attrs = e->pl().getAttrs();
+        props.insert(attrs.begin(), attrs.end());
+
+        feature(geom, props);
+      }
+    }
+
+    _out->flush();
+  }
+
+  void close() {
+    _wr.closeAll();
+    (*_out) << std::endl;
+  }
+
+  void close(const util::json::Dict& props) {
+    // the features array
+    _wr.close();
+    _wr.key("properties");
+    _wr.val(props);
+    _wr.closeAll();
+    (*_out) << std::endl;
+  }
+
+ private:
+  void feature(const util::geo::DPoint& p, const util::json::Dict& props) {
+    openFeature("Point");
+    coords(p);
+    closeFeature(props);
+  }
+
+  void feature(const util::geo::DLine& l, const util::json::Dict& props) {
+    openFeature("LineString");
+    _wr.arr();
+    for (const auto& p : l) coords(p);
+    _wr.close();
+    closeFeature(props);
+  }
+
+  // opens a feature up to its coordinates
+  void openFeature(const std::string& type) {
+    _wr.obj();
+    _wr.keyVal("type", "Feature");
+    _wr.key("geometry");
+    _wr.obj();
+    _wr.keyVal("type", type);
+    _wr.key("coordinates");
+  }
+
+  // closes the geometry and writes the properties of a feature
+  void closeFeature(const util::json::Dict& props) {
+    _wr.close();
+    _wr.key("properties");
+    _wr.val(props);
+    _wr.close();
+  }
+
+  void coords(const util::geo::DPoint& p) {
+    auto ll = util::geo::webMercToLatLng<double>(p.getX(), p.getY());
+    _wr.arr();
+    _wr.val(ll.getX());
+    _wr.val(ll.getY());
+    _wr.close();
+  }
+
+  std::ostream* _out;
+  util::json::Writer _wr;
+};
+
+// _____________________________________________________________________________
+void printStreamed(CompResult* cr, bool gridGraphs, FeatureStream* out) {
+  if (gridGraphs) {
+    for (auto gg : cr->resultGridGraphs) out->print(*gg);
+  } else {
+    for (auto res : cr->resultGraphs) out->print(*res);
+  }
+
+  for (auto res : cr->resultGraphs) delete res;
+  for (auto gg : cr->resultGridGraphs) delete gg;
+
+  cr->resultGraphs.clear();
+  cr->resultGridGraphs.clear();
+}
+
 // _____________________________________________________________________________
 const CombNode* getCenterNd(const CombGraph* cg) {
   const CombNode* ret = 0;
@@ -107,6 +678,23 @@ std::vector<DPolygon> readObstacleFile(const std::string& p) {
   return ret;
 }
 
+// _____________________________________________________________________________
+octi::PrevLayout readPrevLayout(const std::string& p) {
+  octi::PrevLayout ret;
+  std::ifstream s;
+  s.open(p);
+
+  // previous octi output, in lat/lng coordinates
+  LineGraph lg;
+  lg.readFromJson(&s);
+
+  for (auto nd : lg.getNds()) {
+    for (const auto& st : nd->pl().stops()) ret[st.id] = *nd->pl().getGeom();
+  }
+
+  return ret;
+}
+
 // _____________________________________________________________________________
 void drawComp(LineGraph& tg, double avgDist, util::json::Array& jsonScores,
               std::vector<LineGraph*>& resultGraphs,
@@ -114,21 +702,13 @@ void drawComp(LineGraph& tg, double avgDist, util::json::Array& jsonScores,
               const config::Config& cfg) {
   Drawing d;
 
-  Octilinearizer oct(cfg.baseGraphType);
+  Octilinearizer oct(cfg.baseGraphType, cfg.pqType, cfg.gridCacheDir,
+                     cfg.altLandmarks, cfg.coarseLevels, cfg.coarseCorridor);
   LineGraph* res = new LineGraph();
   BaseGraph* gg;
 
-  double gridSize;
-
-  if (util::trim(cfg.gridSize).back() == '%') {
-    double perc = atof(cfg.gridSize.c_str()) / 100;
-    gridSize = avgDist * perc;
-    LOGTO(DEBUG, std::cerr)
-        << "Grid size " << gridSize << " (" << perc * 100 << "%)";
-  } else {
-    gridSize = atof(cfg.gridSize.c_str());
-    LOGTO(DEBUG, std::cerr) << "Grid size " << gridSize;
-  }
+  double gridSize = gridSizeFor(avgDist, cfg);
+  LOGTO(DEBUG, std::cerr) << "Grid size " << gridSize;
 
   // contract degree 2 nodes without any significance (no station, no
   // exception, no change in lines
@@ -143,6 +723,21 @@ void drawComp(LineGraph& tg, double avgDist, util::json::Array& jsonScores,
   // graph to allow drawing
   tg.splitNodes(oct.maxNodeDeg());
 
+  // grid graphs are not cached, so cached results cannot be used for grid
+  // graph output
+  std::string cachePath;
+  if (cfg.resultCacheDir.size() && cfg.printMode != "gridgraph") {
+    cachePath = compCachePath(cfg, compFingerprint(tg, gridSize, cfg));
+
+    CompStats st;
+    if (readCachedComp(cachePath, res, &st)) {
+      LOGTO(DEBUG, std::cerr) << "Loaded component from " << cachePath;
+      if (cfg.writeStats) addCompStats(st, true, cfg, &jsonScores, &totScore);
+      resultGraphs.push_back(res);
+      return;
+    }
+  }
+
   CombGraph cg(&tg, cfg.deg2Heur);
   box = util::geo::pad(box, gridSize + 1);
 
@@ -163,6 +758,7 @@ void drawComp(LineGraph& tg, double avgDist, util::json::Array& jsonScores,
 
   Score sc;
   octi::ilp::ILPStats ilpstats;
+  HeurStats heurStats;
   double time = 0;
 
   if (cfg.optMode == "ilp") {
@@ -171,7 +767,8 @@ void drawComp(LineGraph& tg, double avgDist, util::json::Array& jsonScores,
                      cfg.maxGrDist, cfg.orderMethod, cfg.ilpNoSolve,
                      cfg.enfGeoPen, cfg.hananIters, cfg.ilpTimeLimit,
                      cfg.ilpCacheDir, cfg.ilpCacheThreshold, cfg.ilpNumThreads,
-                     &ilpstats, cfg.ilpSolver, cfg.ilpPath);
+                     &ilpstats, cfg.ilpSolver, cfg.ilpPath, cfg.ilpCorridor,
+                     cfg.ilpCorridorIters);
     time = T_STOP(octi);
     LOGTO(DEBUG, std::cerr)
         << "Schematized using ILP in " << time << " ms, score " << sc.full;
@@ -179,95 +776,45 @@ void drawComp(LineGraph& tg, double avgDist, util::json::Array& jsonScores,
     T_START(octi);
     sc = oct.draw(cg, box, res, &gg, &d, cfg.pens, gridSize, cfg.borderRad,
                   cfg.maxGrDist, cfg.orderMethod, cfg.restrLocSearch,
-                  cfg.enfGeoPen, cfg.hananIters, cfg.obstacles,
-                  cfg.heurLocSearchIters, cfg.abortAfter);
+                  cfg.multiLocSearch, cfg.enfGeoPen, cfg.hananIters,
+                  cfg.obstacles, cfg.prevLayout, cfg.heurLocSearchIters,
+                  cfg.abortAfter, cfg.heurNumThreads, cfg.heurTimeBudget,
+                  &heurStats);
     time = T_STOP(octi);
 
     LOGTO(DEBUG, std::cerr) << "Schematized using heur approach in " << time
                             << " ms, score " << sc.full;
   }
 
-  if (cfg.writeStats) {
-    size_t maxRss = util::getPeakRSS();
-    size_t numEdgs = 0;
-    size_t numEdgsComb = 0;
-    size_t numEdgsTg = 0;
-    for (auto nd : gg->getNds()) {
-      numEdgs += nd->getDeg();
-    }
-    for (auto nd : cg.getNds()) {
-      numEdgsComb += nd->getDeg();
-    }
-    for (auto nd : tg.getNds()) {
-      numEdgsTg += nd->getDeg();
-    }
-
-    // total score
-    totScore.score = totScore.score + sc;
-    totScore.ilpstats = totScore.ilpstats + ilpstats;
-
-    totScore.gridgraphNumNds += gg->getNds().size();
-    totScore.gridgraphNumEdgs += numEdgs / 2;
-    totScore.combgraphNumNds += cg.getNds().size();
-    totScore.combgraphNumEdgs += numEdgsComb / 2;
-    totScore.inputgraphNumNds += tg.getNds().size();
-    totScore.inputgraphNumEdgs += numEdgsTg / 2;
-    totScore.inputgraphMaxDeg =
-        std::max(totScore.inputgraphMaxDeg, tg.maxDeg());
-    totScore.timeMs += time;
-
-    // translate score to JSON
-    util::json::Dict jsonScore = util::json::Dict{
-        {"scores",
-         util::json::Dict{{"total-score", sc.full},
-                          {"topo-violations", util::json::Int(sc.violations)},
-                          {"density-score", sc.dense},
-                          {"bend-score", sc.bend},
-                          {"hop-score", sc.hop},
-                          {"move-score", sc.move}}},
-        {"pens",
-         util::json::Dict{
-             {"density-pen", cfg.pens.densityPen},
-             {"diag-pen", cfg.pens.diagonalPen},
-             {"hori-pen", cfg.pens.horizontalPen},
-             {"vert-pen", cfg.pens.verticalPen},
-             {"180-turn-pen", cfg.pens.p_0},
-             {"135-turn-pen", cfg.pens.p_135},
-             {"90-turn-pen", cfg.pens.p_90},
-             {"45-turn-pen", cfg.pens.p_45},
-         }},
-        {"gridgraph-size", util::json::Dict{{"nodes", gg->getNds().size()},
-                                            {"edges", numEdgs / 2}}},
-        {"combgraph-size", util::json::Dict{{"nodes", cg.getNds().size()},
-                                            {"edges", numEdgsComb / 2}}},
-        {"input-graph-size", util::json::Dict{{"nodes", tg.getNds().size()},
-                                              {"edges", numEdgsTg / 2},
-                                              {"max-deg", tg.maxDeg()}}},
-        {"input-graph-avg-node-dist",
-         avgDist * webMercDistFactor(box.getLowerLeft())},
-        {"area", dist(box.getLowerRight(), box.getLowerLeft()) *
-                     webMercDistFactor(box.getLowerRight()) *
-                     dist(box.getLowerRight(), box.getUpperRight()) *
-                     webMercDistFactor(box.getLowerRight())},
-        {"misc", util::json::Dict{{"method", cfg.optMode},
-                                  {"deg2heur", cfg.deg2Heur},
-                                  {"max-grid-dist", cfg.maxGrDist}}},
-        {"time-ms", time},
-        {"iterations", sc.iters},
-        {"procs", omp_get_num_procs()},
-        {"peak-memory", util::readableSize(maxRss)},
-        {"peak-memory-bytes", maxRss},
-        {"timestamp", util::json::Int(std::time(0))}};
-
-    if (cfg.optMode == "ilp") {
-      jsonScore["ilp"] = util::json::Dict{
-          {"size",
-           util::json::Dict{{"rows", ilpstats.rows}, {"cols", ilpstats.cols}}},
-          {"solve-time", ilpstats.time},
-          {"optimal", util::json::Bool{ilpstats.optimal}}};
-    }
-
-    jsonScores.push_back(jsonScore);
+  CompStats st;
+  st.score = sc;
+  st.ilpstats = ilpstats;
+  st.heurStats = heurStats;
+  st.timeMs = time;
+
+  for (auto nd : gg->getNds()) st.gridgraphNumEdgs += nd->getDeg();
+  for (auto nd : cg.getNds()) st.combgraphNumEdgs += nd->getDeg();
+  for (auto nd : tg.getNds()) st.inputgraphNumEdgs += nd->getDeg();
+  st.gridgraphNumEdgs /= 2;
+  st.combgraphNumEdgs /= 2;
+  st.inputgraphNumEdgs /= 2;
+
+  st.gridgraphNumNds = gg->getNds().size();
+  st.combgraphNumNds = cg.getNds().size();
+  st.inputgraphNumNds = tg.getNds().size();
+  st.inputgraphMaxDeg = tg.maxDeg();
+
+  st.avgNodeDist = avgDist * webMercDistFactor(box.getLowerLeft());
+  st.area = dist(box.getLowerRight(), box.getLowerLeft()) *
+            webMercDistFactor(box.getLowerRight()) *
+            dist(box.getLowerRight(), box.getUpperRight()) *
+            webMercDistFactor(box.getLowerRight());
+
+  if (cfg.writeStats) addCompStats(st, false, cfg, &jsonScores, &totScore);
+
+  // a drawing cut short by the time budget may be improved by a later run
+  if (cachePath.size() && !heurStats.timedOut) {
+    writeCachedComp(cachePath, *res, st);
   }
 
   resultGraphs.push_back(res);
@@ -300,6 +847,13 @@ int main(int argc, char** argv) {
     LOGTO(DEBUG, std::cerr) << "Done. (" << cfg.obstacles.size() << " obst.)";
   }
 
+  if (cfg.prevLayoutPath.size()) {
+    LOGTO(DEBUG, std::cerr) << "Reading previous layout...";
+    cfg.prevLayout = readPrevLayout(cfg.prevLayoutPath);
+    LOGTO(DEBUG, std::cerr) << "Done. (" << cfg.prevLayout.size()
+                            << " stations)";
+  }
+
   LOGTO(DEBUG, std::cerr) << "Reading graph file...";
   T_START(read);
   LineGraph lg;
@@ -319,18 +873,71 @@ int main(int argc, char** argv) {
   std::vector<LineGraph> comps = lg.distConnectedComponents(10000, false);
 
   util::json::Array jsonScores;
-  std::vector<LineGraph*> resultGraphs;
-  std::vector<BaseGraph*> resultGridGraphs;
 
   LOGTO(DEBUG, std::cerr) << "Broke input graph into " << comps.size()
                           << " components";
 
   TotalScore totScore;
 
-  size_t i = 0;
+  // components are drawn independently into their own result slots, which
+  // are merged in input order afterwards, so the output does not depend on
+  // the order in which components finished
+  std::vector<CompResult> compResults(comps.size());
+
+  // largest components first, to not end up waiting for a single big
+  // component started last
+  std::vector<size_t> compOrder(comps.size());
+  for (size_t i = 0; i < comps.size(); i++) compOrder[i] = i;
+  std::stable_sort(compOrder.begin(), compOrder.end(),
+                   [&comps](size_t a, size_t b) {
+                     return comps[a].getNds().size() >
+                            comps[b].getNds().size();
+                   });
+
+  size_t compThreads = std::max<size_t>(1, cfg.compThreads);
+
+  if (cfg.optMode == "ilp" && compThreads > 1) {
+    // the ILP solvers are not thread-safe
+    LOGTO(WARN, std::cerr) << "Components are drawn sequentially in ILP mode, "
+                              "ignoring --comp-threads";
+    compThreads = 1;
+  }
+  config::Config compCfg = cfg;
+
+  if (compThreads > 1) {
+    // split the available threads between components and their heuristic
+    if (compCfg.heurNumThreads == 0) {
+      compCfg.heurNumThreads =
+          std::max<size_t>(1, omp_get_max_threads() / compThreads);
+    }
+    omp_set_max_active_levels(2);
+  }
+
+  MemBudget budget(cfg.compMemBudget * 1024 * 1024);
+
+  // components are printed as soon as they and all components before them in
+  // input order are drawn
+  FeatureStream out(&std::cout);
+  std::vector<char> compDone(comps.size(), 0);
+  size_t nextOut = 0;
+
+  // grid graphs are only printed together with statistics
+  bool printGridGraphs = cfg.printMode == "gridgraph" && cfg.writeStats;
+
+  // the output is always closed, the error is written into its properties
+  auto fail = [&out](const std::string& msg) {
+    LOG(ERROR) << msg;
+    out.close(util::json::Dict{{"error", msg}});
+    exit(1);
+  };
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(compThreads)
+  for (size_t j = 0; j < compOrder.size(); j++) {
+    size_t i = compOrder[j];
+    auto& tg = comps[i];
+    auto& cr = compResults[i];
 
-  for (auto& tg : comps) {
-    LOGTO(DEBUG, std::cerr) << "@ component " << i++;
+    LOGTO(DEBUG, std::cerr) << "@ component " << i;
     double avgDist = avgStatDist(tg);
 
     double curDist = avgDist;
@@ -340,10 +947,13 @@ int main(int argc, char** argv) {
 
     LOGTO(DEBUG, std::cerr) << "Average adj. node distance is " << avgDist;
 
+    size_t memEst = estMemUsage(tg, avgDist, cfg);
+    budget.acquire(memEst);
+
     while (tries < MAX_TRIES) {
       try {
-        drawComp(tg, curDist, jsonScores, resultGraphs, resultGridGraphs,
-                 totScore, cfg);
+        drawComp(tg, curDist, cr.jsonScores, cr.resultGraphs,
+                 cr.resultGridGraphs, cr.totScore, compCfg);
 
         break;
       } catch (const NoEmbeddingFoundExc& exc) {
@@ -355,19 +965,42 @@ int main(int argc, char** argv) {
         }
 
         if (cfg.skipOnError) {
-          totScore.numNoEmbeddingFound += 1;
-          jsonScores.push_back(util::json::Dict());
+          cr.totScore.numNoEmbeddingFound += 1;
+          cr.jsonScores.push_back(util::json::Dict());
           LOGTO(WARN, std::cerr) << exc.what();
           break;
         }
 
-        LOG(ERROR) << exc.what();
-        exit(1);
+        if (compThreads == 1) fail(exc.what());
+
+        // exiting from inside the parallel loop is not safe, the error is
+        // reported in input order below
+        cr.error = exc.what();
+        break;
+      }
+    }
+
+    budget.release(memEst);
+
+#pragma omp critical(streamOutput)
+    {
+      compDone[i] = 1;
+      // an error stops the output, it is reported below
+      while (nextOut < comps.size() && compDone[nextOut] &&
+             compResults[nextOut].error.empty()) {
+        printStreamed(&compResults[nextOut], printGridGraphs, &out);
+        nextOut++;
       }
     }
   }
 
-  util::geo::output::GeoGraphJsonOutput gout;
+  for (auto& cr : compResults) {
+    if (cr.error.size()) fail(cr.error);
+
+    jsonScores.insert(jsonScores.end(), cr.jsonScores.begin(),
+                      cr.jsonScores.end());
+    mergeScore(&totScore, cr.totScore);
+  }
 
   size_t maxRss = util::getPeakRSS();
 
@@ -422,39 +1055,11 @@ int main(int argc, char** argv) {
         {"optimal", util::json::Bool{totScore.ilpstats.optimal}}};
   }
 
-  if (cfg.printMode == "gridgraph") {
-    if (cfg.writeStats) {
-      util::geo::output::GeoJsonOutput out(
-          std::cout, util::json::Dict{{"statistics", totalScore},
-                                      {"component-statistics", jsonScores}});
-      for (auto gg : resultGridGraphs) {
-        gout.printLatLng(*gg, &out);
-      }
-      out.flush();
-    } else {
-      util::geo::output::GeoJsonOutput out(std::cout);
-      for (auto gg : resultGraphs) {
-        gout.printLatLng(*gg, &out);
-      }
-      out.flush();
-    }
+  if (cfg.writeStats) {
+    out.close(util::json::Dict{{"statistics", totalScore},
+                               {"component-statistics", jsonScores}});
   } else {
-    if (cfg.writeStats) {
-      util::geo::output::GeoJsonOutput out(
-          std::cout, util::json::Dict{{"statistics", totalScore},
-                                      {"component-statistics", jsonScores}});
-      for (auto res : resultGraphs) {
-        gout.printLatLng(*res, &out);
-      }
-      out.flush();
-    } else {
-      util::geo::output::GeoJsonOutput out(std::cout);
-
-      for (auto res : resultGraphs) {
-        gout.printLatLng(*res, &out);
-      }
-      out.flush();
-    }
+    out.close();
   }
 
   return 0;
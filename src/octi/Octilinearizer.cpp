@@ -3,13 +3,18 @@
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <fstream>
-#include <thread>
+#include <sstream>
 #include "ilp/ILPGridOptimizer.h"
 #include "octi/Octilinearizer.h"
 #include "octi/basegraph/BaseGraph.h"
 #include "octi/basegraph/ConvexHullOctiGridGraph.h"
+#include "octi/basegraph/CorridorOctiGridGraph.h"
+#include "octi/basegraph/GridDijkstra.h"
 #include "octi/basegraph/GridGraph.h"
+#include "octi/basegraph/GridOverlay.h"
 #include "octi/basegraph/HexGridGraph.h"
 #include "octi/basegraph/NodeCost.h"
 #include "octi/basegraph/OctiGridGraph.h"
@@ -17,12 +22,19 @@
 #include "octi/basegraph/OctiQuadTree.h"
 #include "octi/basegraph/OrthoRadialGraph.h"
 #include "octi/basegraph/PseudoOrthoRadialGraph.h"
+#include "octi/cache/CacheUtil.h"
 #include "octi/combgraph/Drawing.h"
 #include "util/Misc.h"
 #include "util/geo/output/GeoGraphJsonOutput.h"
 #include "util/graph/BiDijkstra.h"
 #include "util/graph/Dijkstra.h"
 #include "util/log/Log.h"
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#define omp_get_thread_num() 0
+#define omp_get_max_threads() 1
+#endif
 
 using namespace octi;
 using namespace basegraph;
@@ -51,7 +63,7 @@ Score Octilinearizer::drawILP(
     double enfGeoPen, size_t hananIters, int timeLim,
     const std::string& cacheDir, double cacheThreshold, int numThreads,
     octi::ilp::ILPStats* stats, const std::string& solverStr,
-    const std::string& path) {
+    const std::string& path, double corridorWidth, size_t corridorIters) {
   BaseGraph* gg;
   Drawing drawing;
 
@@ -66,29 +78,24 @@ Score Octilinearizer::drawILP(
     LineGraph tmpOutTg;
     // important: always use restrLocSearch here!
     auto score = draw(cg, box, &tmpOutTg, &gg, &drawing, pensCpy, gridSize,
-                      borderRad, maxGrDist, orderMethod, true, enfGeoPen,
-                      hananIters, {}, 100, std::numeric_limits<size_t>::max());
+                      borderRad, maxGrDist, orderMethod, true, false,
+                      enfGeoPen,
+                      hananIters, {}, {}, 100,
+                      std::numeric_limits<size_t>::max(), 0, 0, 0);
     if (score.violations) throw NoEmbeddingFoundExc();
     LOGTO(DEBUG, std::cerr) << "Presolving finished.";
   } catch (const NoEmbeddingFoundExc& exc) {
     LOGTO(DEBUG, std::cerr) << "Presolve was not successful.";
-    gg = newBaseGraph(box, cg, gridSize, borderRad, hananIters, pensCpy);
-    gg->init();
+    gg = initBaseGraph(box, cg, gridSize, borderRad, hananIters, pensCpy);
     drawing = Drawing(gg);
   }
 
-  GeoPensMap enfGeoPens;
   const GeoPensMap* geoPens = 0;
 
+  // usually already computed by the presolve
   if (enfGeoPen) {
-    auto edges = getOrdering(cg, OrderMethod::NUM_LINES);
-    LOGTO(DEBUG, std::cerr) << "Writing geopens for " << edges.size() << " edges";
-    T_START(geopens);
-    for (auto cmbEdg : edges) {
-      gg->writeGeoCoursePens(cmbEdg, &enfGeoPens, enfGeoPen);
-    }
-    LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(geopens) << "ms)";
-    geoPens = &enfGeoPens;
+    geoPens = this->geoPens(cg, gg, box, gridSize, borderRad, hananIters,
+                            enfGeoPen, omp_get_max_threads());
   }
 
   // TODO
@@ -104,7 +111,8 @@ Score Octilinearizer::drawILP(
 
   *stats =
       ilpoptim.optimize(gg, cg, &drawing, maxGrDist, noSolve, geoPens, timeLim,
-                        cacheDir, cacheThreshold, numThreads, solverStr, path);
+                        cacheDir, cacheThreshold, numThreads, solverStr, path,
+                        corridorWidth, corridorIters);
 
   drawing.getLineGraph(outTg);
   *retGg = gg;
@@ -122,57 +130,161 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
                            const Penalties& pens, double gridSize,
                            double borderRad, double maxGrDist,
                            OrderMethod orderMethod, bool restrLocSearch,
-                           double enfGeoPen, size_t hananIters,
+                           bool multiLocSearch, double enfGeoPen,
+                           size_t hananIters,
                            const std::vector<Polygon<double>>& obstacles,
-                           size_t locSearchIters, size_t abortAfter) {
-  size_t jobs = 4;
-  std::vector<BaseGraph*> ggs(jobs);
+                           const PrevLayout& prevLayout, size_t locSearchIters,
+                           size_t abortAfter, size_t numThreads,
+                           double timeBudget, HeurStats* stats) {
+  if (_coarseLevels && _baseGraphType == OCTIGRID) {
+    // solve on a grid with twice the cell size first (itself solved coarse
+    // to fine), then only on the fine cells around the coarse drawing
+    auto start = std::chrono::steady_clock::now();
+    GridCorridor corridor(box, gridSize * 2);
+
+    bool coarseDrawn = false;
+
+    {
+      Octilinearizer coarse(_baseGraphType, _pqType, _gridCacheDir,
+                            _numLandmarks, _coarseLevels - 1, _coarseCorridor);
+      LineGraph coarseTg;
+      BaseGraph* coarseGg = 0;
+      Drawing coarseD;
+      HeurStats coarseStats;
+
+      LOGTO(DEBUG, std::cerr) << "Solving on coarse grid of size "
+                              << gridSize * 2 << "...";
+
+      try {
+        coarse.draw(cg, box, &coarseTg, &coarseGg, &coarseD, pens,
+                    gridSize * 2, borderRad, maxGrDist, orderMethod,
+                    restrLocSearch, multiLocSearch, enfGeoPen, hananIters,
+                    obstacles, prevLayout, locSearchIters, abortAfter,
+                    numThreads, timeBudget / 2, &coarseStats);
+        coarseDrawn = true;
+      } catch (const NoEmbeddingFoundExc& exc) {
+        LOGTO(DEBUG, std::cerr) << "No coarse drawing, using the full grid.";
+      }
 
-  LOGTO(DEBUG, std::cerr) << "Creating grid graphs... ";
-  T_START(ggraph);
-#pragma omp parallel for
-  for (size_t i = 0; i < jobs; i++) {
-    ggs[i] = newBaseGraph(box, cg, gridSize, borderRad, hananIters, pens);
-    ggs[i]->init();
+      if (coarseDrawn) {
+        for (auto nd : coarseTg.getNds()) {
+          for (auto e : nd->getAdjList()) {
+            if (e->getFrom() != nd) continue;
+            corridor.add(*e->pl().getGeom(), _coarseCorridor);
+          }
+        }
+
+        // the fine candidate positions of each node must be covered
+        for (auto nd : cg.getNds()) {
+          corridor.add(*nd->pl().getGeom(),
+                       _coarseCorridor + std::ceil(maxGrDist / 2));
+        }
+
+        delete coarseGg;
+      }
+    }
+
+    if (coarseDrawn) {
+      LOGTO(DEBUG, std::cerr) << "Corridor covers " << corridor.size()
+                              << " of " << corridor.numCells()
+                              << " coarse cells";
+
+      double fineBudget = 0;
+      if (timeBudget > 0) {
+        double elapsed = std::chrono::duration<double, std::milli>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+        fineBudget = std::max(1.0, timeBudget - elapsed);
+      }
+
+      Octilinearizer fine(_baseGraphType, _pqType, _gridCacheDir,
+                          _numLandmarks);
+      fine._corridor = &corridor;
+
+      try {
+        return fine.draw(cg, box, outTg, retGg, dOut, pens, gridSize,
+                         borderRad, maxGrDist, orderMethod, restrLocSearch,
+                         multiLocSearch, enfGeoPen, hananIters, obstacles,
+                         prevLayout, locSearchIters, abortAfter, numThreads,
+                         fineBudget, stats);
+      } catch (const NoEmbeddingFoundExc& exc) {
+        // the corridor may cut off a drawing the full grid allows
+        LOGTO(DEBUG, std::cerr)
+            << "No drawing inside the corridor, using the full grid.";
+      }
+    }
+
+    if (timeBudget > 0) {
+      double elapsed = std::chrono::duration<double, std::milli>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+      timeBudget = std::max(1.0, timeBudget - elapsed);
+    }
   }
 
+  // with a time budget (ms), the search is stopped at the deadline and the
+  // best drawing found so far is returned
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::microseconds(static_cast<int64_t>(
+                      timeBudget > 0 ? timeBudget * 1000 : 0));
+  auto timedOut = [&]() {
+    return timeBudget > 0 && std::chrono::steady_clock::now() >= deadline;
+  };
+
+  std::vector<std::pair<double, double>> trajectory;
+  bool stoppedByBudget = false;
+
+  // a single grid graph is shared by all worker threads, each thread only
+  // holds a copy-on-write overlay of the grid nodes and edges it modified
+  size_t jobs = numThreads;
+  if (jobs == 0) jobs = omp_get_max_threads();
+
+  std::vector<GridOverlay> overlays(jobs);
+
+  std::vector<double> busyMs(jobs, 0);
+  std::vector<size_t> tasks(jobs, 0);
+
+  LOGTO(DEBUG, std::cerr) << "Creating grid graph... ";
+  T_START(ggraph);
+  BaseGraph* gg = initBaseGraph(box, cg, gridSize, borderRad, hananIters, pens);
+
   LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(ggraph) << "ms)";
 
-  LOGTO(DEBUG, std::cerr) << "Grid graph has " << ggs[0]->getNds().size()
+  LOGTO(DEBUG, std::cerr) << "Grid graph has " << gg->getNds().size()
                           << " nodes";
 
+  // one shortest path workspace per thread, reused for all searches
+  std::vector<GridDijkstra> searches(jobs, GridDijkstra(gg, _pqType));
+
   size_t LOCAL_SEARCH_ITERS = locSearchIters;
   double CONVERGENCE_THRESHOLD = 0.05;
 
-  GeoPensMap enfGeoPens;
   const GeoPensMap* geoPens = 0;
 
-  // ordering is irrelevant, this is a just a shortcut to get all edges
-  auto edges = getOrdering(cg, OrderMethod::NUM_LINES);
-
   if (enfGeoPen > 0) {
-    LOGTO(DEBUG, std::cerr) << "Writing geopens for " << edges.size() << " edges";
-    T_START(geopens);
-    size_t i = 0;
-    for (auto cmbEdg : edges) {
-      i++;
-      LOGTO(DEBUG, std::cerr) << "@ " << i << "/" << edges.size();
-      ggs[0]->writeGeoCoursePens(cmbEdg, &enfGeoPens, enfGeoPen);
-    }
-    LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(geopens) << "ms)";
-    geoPens = &enfGeoPens;
+    geoPens = this->geoPens(cg, gg, box, gridSize, borderRad, hananIters,
+                            enfGeoPen, jobs);
   }
 
   if (obstacles.size()) {
     LOGTO(DEBUG, std::cerr) << "Writing obstacles... ";
     T_START(obstacles);
-    for (auto gg : ggs)
-      for (const auto& obst : obstacles) gg->addObstacle(obst);
+    // obstacles are part of the shared cost layer
+    for (const auto& obst : obstacles) gg->addObstacle(obst);
     LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(obstacles) << "ms)";
   }
 
+  if (_numLandmarks) {
+    LOGTO(DEBUG, std::cerr) << "Computing " << _numLandmarks
+                            << " landmarks... ";
+    T_START(landmarks);
+    // landmark distances are taken from the static costs written so far
+    gg->writeLandmarks(_numLandmarks);
+    LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(landmarks) << "ms)";
+  }
+
   // this is the best drawing
-  Drawing drawing(ggs[0]);
+  Drawing drawing(gg);
 
   // try our default edge ordering first, without any randomization
 
@@ -185,42 +297,87 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
     methods = {orderMethod};
   }
 
-  std::vector<std::vector<OrderMethod>> batches(jobs);
-  for (size_t i = 0; i < methods.size(); i++) {
-    batches[i % jobs].push_back(methods[i]);
+  LOGTO(DEBUG, std::cerr) << "Searching initial drawing... ";
+
+  T_START(wall);
+
+  // with a previous layout, the unchanged nodes are first fixed to their
+  // previous positions. If this gives a drawing, the orderings are not tried.
+  SettledPos warmPos;
+  if (prevLayout.size()) {
+    warmPos = warmStartPos(cg, gg, prevLayout, maxGrDist);
+
+    LOGTO(DEBUG, std::cerr) << "Warm start with " << warmPos.size() << " of "
+                            << cg.getNds().size() << " nodes fixed";
   }
 
-  LOGTO(DEBUG, std::cerr) << "Searching initial drawing... ";
+  if (warmPos.size()) {
+    T_START(draw);
+    GridOverlayScope scope(&overlays[0]);
+    Drawing drawingCp(gg);
+
+    auto status = draw(getOrdering(cg, methods.front()), warmPos, gg,
+                       &drawingCp, INF, maxGrDist, geoPens, abortAfter,
+                       &searches[0]);
+    overlays[0].clear();
+
+    statLine(status, "Warm start", drawingCp, T_STOP(draw), "*");
+
+    if (status == DRAWN) {
+      drawing = drawingCp;
+      methods.clear();
+    } else {
+      drawingCp.crumble();
+      warmPos.clear();
+    }
+  }
 
-#pragma omp parallel for
-  for (size_t btch = 0; btch < jobs; btch++) {
-    for (OrderMethod meth : batches[btch]) {
-      T_START(draw);
-      Drawing drawingCp(ggs[btch]);
+  // orderings are handed out dynamically, each thread draws on the overlay
+  // belonging to it
+#pragma omp parallel for schedule(dynamic) num_threads(jobs)
+  for (size_t i = 0; i < methods.size(); i++) {
+    size_t btch = omp_get_thread_num();
+    OrderMethod meth = methods[i];
+    GridOverlayScope scope(&overlays[btch]);
 
-      // get a randomized ordering
-      std::vector<CombEdge*> iterOrder = getOrdering(cg, meth);
+    if (timedOut()) {
+      // past the deadline, only go on if we have nothing to return yet
+      bool haveDrawing = false;
+#pragma omp critical
+      { haveDrawing = drawing.score() != INF; }
+      if (haveDrawing) continue;
+    }
 
-      double bestScoreSoFar = 0;
+    T_START(draw);
+    Drawing drawingCp(gg);
+
+    // get a randomized ordering
+    std::vector<CombEdge*> iterOrder = getOrdering(cg, meth);
+
+    double bestScoreSoFar = 0;
 
 #pragma omp critical
-      { bestScoreSoFar = drawing.score(); }
+    { bestScoreSoFar = drawing.score(); }
+
+    auto status = draw(iterOrder, gg, &drawingCp, bestScoreSoFar, maxGrDist,
+                       geoPens, abortAfter, &searches[btch]);
 
-      auto status = draw(iterOrder, ggs[btch], &drawingCp, bestScoreSoFar,
-                         maxGrDist, geoPens, abortAfter);
+    // dropping the overlay restores the untouched grid
+    overlays[btch].clear();
 
-      drawingCp.eraseFromGrid(ggs[btch]);
+    double ms = T_STOP(draw);
+    busyMs[btch] += ms;
+    tasks[btch]++;
 
-      statLine(status, std::string("Try ") + std::to_string(meth), drawingCp,
-               T_STOP(draw), "*");
+    statLine(status, std::string("Try ") + std::to_string(meth), drawingCp, ms,
+             "*");
 
 #pragma omp critical
-      {
-        if (status == DRAWN && drawingCp.score() < drawing.score()) {
-          drawing = drawingCp;
-        } else {
-          drawingCp.crumble();
-        }
+    {
+      if (status == DRAWN && drawingCp.score() < drawing.score()) {
+        drawing = drawingCp;
+      } else {
+        drawingCp.crumble();
       }
     }
   }
@@ -229,7 +386,12 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
 
   LOGTO(DEBUG, std::cerr) << "Done.";
 
-  for (size_t i = 0; i < jobs; i++) drawing.applyToGrid(ggs[i]);
+  trajectory.push_back({T_STOP(wall), drawing.score()});
+
+  for (size_t i = 0; i < jobs; i++) {
+    GridOverlayScope scope(&overlays[i]);
+    drawing.applyToGrid(gg);
+  }
 
   size_t iters = 0;
 
@@ -240,78 +402,132 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
   // dont use local search if abortAfter is set
   if (abortAfter != std::numeric_limits<size_t>::max()) LOCAL_SEARCH_ITERS = 0;
 
-  std::vector<std::vector<CombNode*>> batchesLoc(jobs);
-  size_t c = 0;
+  std::vector<CombNode*> locNds;
   for (auto nd : cg.getNds()) {
     if (nd->getDeg() == 0) continue;
-    batchesLoc[c % jobs].push_back(nd);
-    c++;
+
+    // after a warm start, only nodes which are new or next to a new node are
+    // moved, to keep the layout stable
+    if (warmPos.size()) {
+      bool changed = !warmPos.count(nd);
+      for (auto e : nd->getAdjList()) {
+        if (!warmPos.count(e->getOtherNd(nd))) changed = true;
+      }
+      if (!changed) continue;
+    }
+
+    locNds.push_back(nd);
   }
 
   for (; iters < LOCAL_SEARCH_ITERS; iters++) {
+    if (timedOut()) {
+      stoppedByBudget = true;
+      break;
+    }
+
     T_START(iter);
     std::vector<Drawing> bestFrIters(jobs);
 
-#pragma omp parallel for
-    for (size_t btch = 0; btch < jobs; btch++) {
-      for (auto a : batchesLoc[btch]) {
-        Drawing drawingCp = drawing;
+    // per-thread working copy of the current drawing, moves are tried on it
+    // transactionally and rolled back afterwards
+    std::vector<Drawing> work(jobs);
+    std::vector<char> hasWork(jobs, false);
+
+    // in multi move mode, the best position found for each candidate node,
+    // and the score of the drawing after moving it there
+    std::vector<GridNode*> movePos(multiLocSearch ? locNds.size() : 0, 0);
+    std::vector<double> moveScore(multiLocSearch ? locNds.size() : 0, INF);
+
+    // candidate nodes are handed out dynamically, as the number of positions
+    // to test (and their routing costs) differ widely between nodes
+#pragma omp parallel for schedule(dynamic) num_threads(jobs)
+    for (size_t i = 0; i < locNds.size(); i++) {
+      size_t btch = omp_get_thread_num();
+      auto a = locNds[i];
+
+      // the remaining candidates of this iteration are skipped, the best
+      // moves found so far are still valid
+      if (timedOut()) continue;
+
+      GridOverlayScope scope(&overlays[btch]);
+
+      T_START(move);
+      if (!hasWork[btch]) {
+        work[btch] = drawing;
+        hasWork[btch] = true;
+      }
 
-        // use the batches grid graph
-        drawingCp.setBaseGraph(ggs[btch]);
+      Drawing& drawingCp = work[btch];
+      auto grNd = drawingCp.getGrNd(a);
 
-        // reverting a
-        std::vector<CombEdge*> test;
-        for (auto ce : a->getAdjList()) {
-          test.push_back(ce);
+      drawingCp.checkpoint();
 
-          drawingCp.eraseFromGrid(ce, ggs[btch]);
-          drawingCp.erase(ce);
-        }
+      // reverting a
+      std::vector<CombEdge*> test;
+      for (auto ce : a->getAdjList()) {
+        test.push_back(ce);
 
-        drawingCp.erase(a);
-        ggs[btch]->unSettleNd(a);
+        drawingCp.eraseFromGrid(ce, gg);
+        drawingCp.erase(ce);
+      }
 
-        for (size_t pos = 0; pos < ggs[btch]->maxDeg() + 1; pos++) {
-          SettledPos p;
+      drawingCp.erase(a);
+      gg->unSettleNd(a);
 
-          auto n = ggs[btch]->neigh(drawing.getGrNd(a), pos);
-          if (!n) continue;
+      for (size_t pos = 0; pos < gg->maxDeg() + 1; pos++) {
+        SettledPos p;
 
-          p[a] = n;
+        auto n = gg->neigh(grNd, pos);
+        if (!n) continue;
 
-          if (restrLocSearch) {
-            // dont try positions outside the move radius for consistency with
-            // ILP approach
-            double gridD = dist(*a->pl().getGeom(), *n->pl().getGeom());
-            double maxDis = ggs[btch]->getCellSize() * maxGrDist;
-            if (gridD >= maxDis) continue;
-          }
+        p[a] = n;
 
-          Drawing run = drawingCp;
+        if (restrLocSearch) {
+          // dont try positions outside the move radius for consistency with
+          // ILP approach
+          double gridD = dist(*a->pl().getGeom(), *n->pl().getGeom());
+          double maxDis = gg->getCellSize() * maxGrDist;
+          if (gridD >= maxDis) continue;
+        }
 
-          // we can use bestFromIter.score() as the limit for the shortest
-          // path computation, as we can already do at least as good.
-          auto error =
-              draw(test, p, ggs[btch], &run, bestFrIters[btch].score(),
-                   maxGrDist, geoPens, std::numeric_limits<size_t>::max());
+        drawingCp.checkpoint();
 
-          if (!error && bestFrIters[btch].score() > run.score()) {
-            bestFrIters[btch] = run;
-          }
+        // we can use bestFromIter.score() as the limit for the shortest
+        // path computation, as we can already do at least as good. In multi
+        // move mode, any improvement of this node is of interest.
+        double limit = bestFrIters[btch].score();
+        if (multiLocSearch) limit = std::min(moveScore[i], drawing.score());
 
-          // reset grid
-          for (auto ce : a->getAdjList()) run.eraseFromGrid(ce, ggs[btch]);
-          if (ggs[btch]->isSettled(a)) ggs[btch]->unSettleNd(a);
+        auto error =
+            draw(test, p, gg, &drawingCp, limit, maxGrDist, geoPens,
+                 std::numeric_limits<size_t>::max(), &searches[btch]);
+
+        // only copy the drawing if it is an improvement
+        if (!error && bestFrIters[btch].score() > drawingCp.score()) {
+          bestFrIters[btch] = drawingCp;
+        }
+
+        if (multiLocSearch && !error && drawingCp.score() < limit) {
+          moveScore[i] = drawingCp.score();
+          movePos[i] = n;
         }
 
-        ggs[btch]->settleNd(const_cast<GridNode*>(ggs[btch]->getGrNdById(
-                                drawing.getGrNd(a)->pl().getId())),
-                            a);
+        // reset grid
+        for (auto ce : a->getAdjList()) drawingCp.eraseFromGrid(ce, gg);
+        if (gg->isSettled(a)) gg->unSettleNd(a);
 
-        // re-settle edges
-        for (auto ce : a->getAdjList()) drawing.applyToGrid(ce, ggs[btch]);
+        drawingCp.rollback();
       }
+
+      drawingCp.rollback();
+
+      gg->settleNd(const_cast<GridNode*>(grNd), a);
+
+      // re-settle edges
+      for (auto ce : a->getAdjList()) drawingCp.applyToGrid(ce, gg);
+
+      busyMs[btch] += T_STOP(move);
+      tasks[btch]++;
     }
 
     size_t bestCore = 0;
@@ -323,21 +539,77 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
       }
     }
 
-    double imp = (drawing.score() - bestFrIters[bestCore].score());
+    double prevScore = drawing.score();
+    double imp = (prevScore - bestFrIters[bestCore].score());
     LOGTO(DEBUG, std::cerr)
         << " ++ Iter " << iters << ", prev " << drawing.score() << ", next "
         << bestFrIters[bestCore].score() << " (" << (imp >= 0 ? "+" : "") << imp
         << ", " << T_STOP(iter) << " ms)";
 
+    // an iteration cut short by the deadline may not have found anything
+    bool partial = timedOut();
+    if (partial && imp <= 0) {
+      stoppedByBudget = true;
+      break;
+    }
+
+    if (multiLocSearch && !partial) {
+      // commit all non-conflicting improvements on the first overlay, which
+      // holds the current drawing
+      GridOverlayScope scope(&overlays[0]);
+      size_t moved = applyMoves(locNds, movePos, moveScore, gg, &drawing,
+                                maxGrDist, geoPens, &searches[0]);
+      imp = prevScore - drawing.score();
+      LOGTO(DEBUG, std::cerr) << " ++ Iter " << iters << ", " << moved
+                              << " moves committed, next " << drawing.score();
+    } else {
+      drawing = bestFrIters[bestCore];
+    }
+
     for (size_t i = 0; i < jobs; i++) {
-      drawing.eraseFromGrid(ggs[i]);
-      bestFrIters[bestCore].applyToGrid(ggs[i]);
+      GridOverlayScope scope(&overlays[i]);
+      overlays[i].clear();
+      drawing.applyToGrid(gg);
+    }
+
+    trajectory.push_back({T_STOP(wall), drawing.score()});
+
+    if (partial) {
+      stoppedByBudget = true;
+      iters++;
+      break;
     }
-    drawing = bestFrIters[bestCore];
 
     if (imp < CONVERGENCE_THRESHOLD) break;
   }
 
+  if (stoppedByBudget) {
+    LOGTO(DEBUG, std::cerr) << "Time budget of " << timeBudget
+                            << " ms exhausted after " << iters
+                            << " local search iterations.";
+  }
+
+  double wallMs = T_STOP(wall);
+
+  for (size_t i = 0; i < jobs; i++) {
+    LOGTO(DEBUG, std::cerr)
+        << "Thread " << i << ": " << tasks[i] << " tasks, busy " << busyMs[i]
+        << " ms (" << (wallMs > 0 ? 100.0 * busyMs[i] / wallMs : 0) << "%), "
+        << overlays[i].size() << " overlay entries, "
+        << searches[i].numSearches() << " searches ("
+        << searches[i].numFallbacks() << " binary heap fallbacks)";
+  }
+
+  if (stats) {
+    stats->threads = jobs;
+    stats->wallMs = wallMs;
+    stats->threadBusyMs = busyMs;
+    stats->threadTasks = tasks;
+    stats->iters = iters;
+    stats->timedOut = stoppedByBudget;
+    stats->scoreTrajectory = trajectory;
+  }
+
   drawing.getLineGraph(outTg);
   auto fullScore = drawing.fullScore();
   LOGTO(DEBUG, std::cerr) << "Topo violations: " << drawing.violations()
@@ -346,16 +618,61 @@ Score Octilinearizer::draw(const CombGraph& cg, const DBox& box,
                           << ", mv costs: " << fullScore.move
                           << ", dense costs: " << fullScore.dense;
 
-  *retGg = ggs[0];
-  *dOut = drawing;
+  // the overlays are not needed anymore, write the final drawing to the
+  // shared grid graph itself (this is important for drawILP)
+  for (auto& o : overlays) o.clear();
+  drawing.applyToGrid(gg);
 
-  // the drawing might still have another internal grid graph, make sure they
-  // match (this is important for drawILP)
-  dOut->setBaseGraph(ggs[0]);
+  *retGg = gg;
+  *dOut = drawing;
   fullScore.iters = iters;
   return fullScore;
 }
 
+// _____________________________________________________________________________
+const GeoPensMap* Octilinearizer::geoPens(const CombGraph& cg,
+                                          const BaseGraph* gg, const DBox& box,
+                                          double gridSize, double borderRad,
+                                          size_t hananIters, double pen,
+                                          size_t jobs) {
+  // grid edge ids only depend on the grid parameters, so penalties computed
+  // for an identical grid can be reused
+  const auto& k = _geoPensKey;
+  if (_hasGeoPens && k.cg == &cg && k.gridSize == gridSize &&
+      k.borderRad == borderRad && k.hananIters == hananIters && k.pen == pen &&
+      k.box.getLowerLeft().getX() == box.getLowerLeft().getX() &&
+      k.box.getLowerLeft().getY() == box.getLowerLeft().getY() &&
+      k.box.getUpperRight().getX() == box.getUpperRight().getX() &&
+      k.box.getUpperRight().getY() == box.getUpperRight().getY()) {
+    LOGTO(DEBUG, std::cerr) << "Reusing geopens for " << _geoPens.numRows()
+                            << " edges";
+    return &_geoPens;
+  }
+
+  // ordering is irrelevant, this is a just a shortcut to get all edges
+  auto edges = getOrdering(cg, OrderMethod::NUM_LINES);
+
+  LOGTO(DEBUG, std::cerr) << "Writing geopens for " << edges.size() << " edges";
+  T_START(geopens);
+
+  std::vector<basegraph::GeoPensRow> rows(cg.numEdgIds());
+
+  // rows are independent, the grid graph is only read
+#pragma omp parallel for schedule(dynamic) num_threads(jobs)
+  for (size_t i = 0; i < edges.size(); i++) {
+    gg->writeGeoCoursePens(edges[i], &rows[edges[i]->pl().getId()], pen);
+  }
+
+  _geoPens = GeoPensMap(&rows);
+  _geoPensKey = {&cg, box, gridSize, borderRad, pen, hananIters};
+  _hasGeoPens = true;
+
+  LOGTO(DEBUG, std::cerr) << "Done. (" << T_STOP(geopens) << "ms, "
+                          << _geoPens.size() << " entries)";
+
+  return &_geoPens;
+}
+
 // _____________________________________________________________________________
 void Octilinearizer::settleRes(GridNode* frGrNd, GridNode* toGrNd,
                                BaseGraph* gg, CombNode* from, CombNode* to,
@@ -382,14 +699,138 @@ void Octilinearizer::writeNdCosts(GridNode* n, CombNode* origNode, CombEdge* e,
   g->addCostVec(n, c);
 }
 
+// _____________________________________________________________________________
+SettledPos Octilinearizer::warmStartPos(const CombGraph& cg,
+                                        const BaseGraph* gg,
+                                        const PrevLayout& prevLayout,
+                                        double maxGrDist) const {
+  SettledPos ret;
+  std::set<const GridNode*> used;
+
+  double maxDis = gg->getCellSize() * maxGrDist;
+
+  for (auto nd : cg.getNds()) {
+    const auto& stops = nd->pl().getParent()->pl().stops();
+    if (stops.empty()) continue;
+
+    auto prev = prevLayout.find(stops.front().id);
+    if (prev == prevLayout.end()) continue;
+
+    // nodes that moved too far are treated as new
+    if (dist(prev->second, *nd->pl().getGeom()) >= maxDis) continue;
+
+    auto cands = gg->getGridNdCands(prev->second, 1);
+    if (cands.empty()) continue;
+
+    auto grNd = cands.top().n;
+    if (used.count(grNd)) continue;
+
+    used.insert(grNd);
+    ret[nd] = grNd;
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+size_t Octilinearizer::applyMoves(const std::vector<CombNode*>& nds,
+                                  const std::vector<GridNode*>& pos,
+                                  const std::vector<double>& scores,
+                                  BaseGraph* gg, Drawing* drawing,
+                                  double maxGrDist, const GeoPensMap* geoPens,
+                                  GridDijkstra* search) {
+  // improving moves, best first
+  std::vector<size_t> cands;
+  for (size_t i = 0; i < nds.size(); i++) {
+    if (pos[i] && scores[i] < drawing->score()) cands.push_back(i);
+  }
+
+  std::stable_sort(cands.begin(), cands.end(), [&scores](size_t a, size_t b) {
+    return scores[a] < scores[b];
+  });
+
+  // comb nodes adjacent to a moved node, and the grid area around each move
+  std::set<const CombNode*> touched;
+  std::vector<DBox> boxes;
+  size_t moved = 0;
+
+  for (auto i : cands) {
+    auto a = nds[i];
+    auto grNd = drawing->getGrNd(a);
+
+    // moves of nodes sharing an edge or a neighbor change each other's
+    // costs, and so do moves whose edges are routed through the same area
+    bool conflict = touched.count(a);
+    DBox box = util::geo::extendBox(*pos[i]->pl().getGeom(), DBox());
+    box = util::geo::extendBox(*grNd->pl().getGeom(), box);
+
+    for (auto ce : a->getAdjList()) {
+      auto other = ce->getOtherNd(a);
+      if (touched.count(other)) conflict = true;
+      box = util::geo::extendBox(*drawing->getGrNd(other)->pl().getGeom(), box);
+    }
+
+    box = util::geo::pad(box, gg->getCellSize());
+    for (const auto& b : boxes) {
+      if (util::geo::intersects(b, box)) conflict = true;
+    }
+
+    if (conflict) continue;
+
+    // the move was evaluated against the drawing of the last iteration, so
+    // it is only kept if it still improves the current drawing
+    double prevScore = drawing->score();
+
+    drawing->checkpoint();
+
+    std::vector<CombEdge*> test;
+    for (auto ce : a->getAdjList()) {
+      test.push_back(ce);
+
+      drawing->eraseFromGrid(ce, gg);
+      drawing->erase(ce);
+    }
+
+    drawing->erase(a);
+    gg->unSettleNd(a);
+
+    SettledPos p;
+    p[a] = pos[i];
+
+    auto error = draw(test, p, gg, drawing, prevScore, maxGrDist, geoPens,
+                      std::numeric_limits<size_t>::max(), search);
+
+    if (!error && drawing->score() < prevScore) {
+      drawing->commit();
+
+      touched.insert(a);
+      for (auto ce : a->getAdjList()) touched.insert(ce->getOtherNd(a));
+      boxes.push_back(box);
+      moved++;
+      continue;
+    }
+
+    // reset grid
+    for (auto ce : a->getAdjList()) drawing->eraseFromGrid(ce, gg);
+    if (gg->isSettled(a)) gg->unSettleNd(a);
+
+    drawing->rollback();
+
+    gg->settleNd(const_cast<GridNode*>(grNd), a);
+    for (auto ce : a->getAdjList()) drawing->applyToGrid(ce, gg);
+  }
+
+  return moved;
+}
+
 // _____________________________________________________________________________
 Undrawable Octilinearizer::draw(const std::vector<CombEdge*>& order,
                                 BaseGraph* gg, Drawing* drawing, double cutoff,
                                 double maxGrDist, const GeoPensMap* geoPensMap,
-                                size_t abortAfter) {
+                                size_t abortAfter, GridDijkstra* search) {
   SettledPos emptyPos;
   return draw(order, emptyPos, gg, drawing, cutoff, maxGrDist, geoPensMap,
-              abortAfter);
+              abortAfter, search);
 }
 
 // _____________________________________________________________________________
@@ -397,7 +838,7 @@ Undrawable Octilinearizer::draw(const std::vector<CombEdge*>& ord,
                                 const SettledPos& settled, BaseGraph* gg,
                                 Drawing* drawing, double globCutoff,
                                 double maxGrDist, const GeoPensMap* geoPensMap,
-                                size_t abortAfter) {
+                                size_t abortAfter, GridDijkstra* search) {
   SettledPos retPos;
 
   size_t i = 0;
@@ -485,11 +926,11 @@ Undrawable Octilinearizer::draw(const std::vector<CombEdge*>& ord,
     if (geoPensMap) {
       // init cost function with geo distance penalties
       auto cost = GridCostGeoPen(cutoff + costOffsetTo + costOffsetFrom,
-                                 &geoPensMap->find(cmbEdg)->second);
-      Dijkstra::shortestPath(frGrNds, toGrNds, cost, *heur, &eL, &nL);
+                                 geoPensMap->row(cmbEdg->pl().getId()));
+      search->shortestPath(frGrNds, toGrNds, cost, *heur, &eL, &nL);
     } else {
       auto cost = GridCost(cutoff + costOffsetTo + costOffsetFrom);
-      Dijkstra::shortestPath(frGrNds, toGrNds, cost, *heur, &eL, &nL);
+      search->shortestPath(frGrNds, toGrNds, cost, *heur, &eL, &nL);
     }
 
     delete heur;
@@ -632,6 +1073,10 @@ BaseGraph* Octilinearizer::newBaseGraph(const DBox& bbox, const CombGraph& cg,
                                         const Penalties& pens) const {
   switch (_baseGraphType) {
     case OCTIGRID:
+      if (_corridor) {
+        return new CorridorOctiGridGraph(*_corridor, bbox, cellSize, spacer,
+                                         pens);
+      }
       return new OctiGridGraph(bbox, cellSize, spacer, pens);
     case CONVEXHULLOCTIGRID:
       return new ConvexHullOctiGridGraph(hull(cg), bbox, cellSize, spacer,
@@ -653,6 +1098,65 @@ BaseGraph* Octilinearizer::newBaseGraph(const DBox& bbox, const CombGraph& cg,
   }
 }
 
+// _____________________________________________________________________________
+BaseGraph* Octilinearizer::initBaseGraph(const DBox& bbox, const CombGraph& cg,
+                                         double cellSize, double spacer,
+                                         size_t hananIters,
+                                         const Penalties& pens) const {
+  BaseGraph* gg = newBaseGraph(bbox, cg, cellSize, spacer, hananIters, pens);
+
+  if (_gridCacheDir.empty()) {
+    gg->init();
+    return gg;
+  }
+
+  uint64_t key = gridCacheKey(bbox, cellSize, spacer, hananIters, pens);
+  std::stringstream ss;
+  ss << _gridCacheDir << "/" << std::hex << key << ".grid";
+  std::string path = ss.str();
+
+  std::ifstream in(path, std::ios::binary);
+  if (in.good() && gg->initFromCache(&in, key)) {
+    LOGTO(DEBUG, std::cerr) << "Loaded grid graph from " << path;
+    return gg;
+  }
+
+  gg->init();
+
+  bool ok = octi::cache::writeAtomic(
+      path, [gg, key](std::ostream* out) { return gg->writeCache(out, key); });
+  if (ok) LOGTO(DEBUG, std::cerr) << "Wrote grid graph to " << path;
+
+  return gg;
+}
+
+// _____________________________________________________________________________
+uint64_t Octilinearizer::gridCacheKey(const DBox& bbox, double cellSize,
+                                      double spacer, size_t hananIters,
+                                      const Penalties& pens) const {
+  // everything init() depends on. Obstacles are not included, they are
+  // written after the graph was built.
+  octi::cache::Fingerprint f;
+
+  int type = _baseGraphType;
+  f.add(&type, sizeof(type));
+
+  double vals[] = {bbox.getLowerLeft().getX(),  bbox.getLowerLeft().getY(),
+                   bbox.getUpperRight().getX(), bbox.getUpperRight().getY(),
+                   cellSize,                    spacer,
+                   pens.p_0,                    pens.p_45,
+                   pens.p_90,                   pens.p_135,
+                   pens.verticalPen,            pens.horizontalPen,
+                   pens.diagonalPen,            pens.densityPen,
+                   pens.ndMovePen};
+  f.add(vals, sizeof(vals));
+
+  uint64_t iters = hananIters;
+  f.add(&iters, sizeof(iters));
+
+  return f.get();
+}
+
 // _____________________________________________________________________________
 DPolygon Octilinearizer::hull(const CombGraph& cg) const {
   MultiPoint<double> points;
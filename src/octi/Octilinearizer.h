@@ -5,11 +5,15 @@
 #ifndef OCTI_OCTILINEARIZER_H_
 #define OCTI_OCTILINEARIZER_H_
 
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "ilp/ILPGridOptimizer.h"
 #include "octi/basegraph/BaseGraph.h"
+#include "octi/basegraph/GridCorridor.h"
+#include "octi/basegraph/GridDijkstra.h"
 #include "octi/basegraph/GridGraph.h"
 #include "octi/combgraph/CombGraph.h"
 #include "octi/combgraph/Drawing.h"
@@ -23,6 +27,7 @@ namespace octi {
 using octi::basegraph::GeoPens;
 using octi::basegraph::GeoPensMap;
 using octi::basegraph::GridEdge;
+using octi::basegraph::GridDijkstra;
 using octi::basegraph::GridEdgePL;
 using octi::basegraph::GridGraph;
 using octi::basegraph::GridNode;
@@ -49,6 +54,9 @@ typedef util::graph::NList<GridNodePL, GridEdgePL> GrNdList;
 typedef std::pair<std::set<GridNode*>, std::set<GridNode*>> RtPair;
 typedef std::map<CombNode*, const GridNode*> SettledPos;
 
+// grid-free node positions of a previous drawing, by station id
+typedef std::unordered_map<std::string, util::geo::DPoint> PrevLayout;
+
 enum Undrawable { DRAWN = 0, NO_PATH = 1, NO_CANDS = 2 };
 
 // exception thrown when no planar embedding could be found
@@ -120,6 +128,27 @@ struct EdgeCmpDeg {
   }
 };
 
+// utilization statistics of the heuristic's worker pool
+struct HeurStats {
+  size_t threads = 0;
+  double wallMs = 0;
+
+  // time each worker thread spent on initial orderings / local search moves
+  std::vector<double> threadBusyMs;
+
+  // number of orderings and local search candidate nodes per worker thread
+  std::vector<size_t> threadTasks;
+
+  // completed local search iterations, and whether the search was stopped
+  // by the time budget
+  size_t iters = 0;
+  bool timedOut = false;
+
+  // (wall time in ms, score) after the initial drawing and after each local
+  // search iteration
+  std::vector<std::pair<double, double>> scoreTrajectory;
+};
+
 struct GraphMeasures {
   double maxNodeDist;
   double minNodeDist;
@@ -147,7 +176,7 @@ struct GridCost
 
 struct GridCostGeoPen
     : public Dijkstra::CostFunc<GridNodePL, GridEdgePL, float> {
-  GridCostGeoPen(float inf, const GeoPens* geoPens)
+  GridCostGeoPen(float inf, const GeoPens& geoPens)
       : _inf(inf), _geoPens(geoPens) {}
   virtual float operator()(const GridNode* from, const GridEdge* e,
                            const GridNode* to) const {
@@ -157,15 +186,15 @@ struct GridCostGeoPen
     // ignore geopens for secondary edges
     if (e->pl().isSecondary()) return e->pl().cost();
 
-    auto i = (*_geoPens).find(e->pl().getId());
-    if (i != _geoPens->end()) return e->pl().cost() + i->second;
+    float pen;
+    if (_geoPens.get(e->pl().getId(), &pen)) return e->pl().cost() + pen;
 
     // if no geopen was present for grid edge, we assume SOFT_INF penalty
     return e->pl().cost() + octi::basegraph::SOFT_INF;
   }
 
   float _inf;
-  const GeoPens* _geoPens;
+  GeoPens _geoPens;
 
   virtual float inf() const { return _inf; }
 };
@@ -173,15 +202,34 @@ struct GridCostGeoPen
 class Octilinearizer {
  public:
   Octilinearizer(basegraph::BaseGraphType baseGraphType)
-      : _baseGraphType(baseGraphType) {}
+      : _baseGraphType(baseGraphType),
+        _pqType(basegraph::PQType::RADIX),
+        _numLandmarks(0),
+        _coarseLevels(0),
+        _coarseCorridor(0),
+        _corridor(0) {}
+  Octilinearizer(basegraph::BaseGraphType baseGraphType,
+                 basegraph::PQType pqType,
+                 const std::string& gridCacheDir = "",
+                 size_t numLandmarks = 0, size_t coarseLevels = 0,
+                 size_t coarseCorridor = 2)
+      : _baseGraphType(baseGraphType),
+        _pqType(pqType),
+        _gridCacheDir(gridCacheDir),
+        _numLandmarks(numLandmarks),
+        _coarseLevels(coarseLevels),
+        _coarseCorridor(coarseCorridor),
+        _corridor(0) {}
 
   Score draw(const CombGraph& cg, const util::geo::DBox& box, LineGraph* out,
              basegraph::BaseGraph** gg, Drawing* d, const Penalties& pens,
              double gridSize, double borderRad, double maxGrDist,
              config::OrderMethod orderMethod, bool restrLocSearch,
-             double enfGeoCourse, size_t hananIters,
+             bool multiLocSearch, double enfGeoCourse, size_t hananIters,
              const std::vector<util::geo::Polygon<double>>& obstacles,
-             size_t locsearchIters, size_t abortAfter);
+             const PrevLayout& prevLayout, size_t locsearchIters,
+             size_t abortAfter, size_t numThreads, double timeBudget,
+             HeurStats* stats);
 
   Score drawILP(const CombGraph& cg, const util::geo::DBox& box, LineGraph* out,
                 basegraph::BaseGraph** gg, Drawing* d, const Penalties& pens,
@@ -190,18 +238,63 @@ class Octilinearizer {
                 double enfGeoPens, size_t hananIters, int timeLim,
                 const std::string& cacheDir, double cacheThreshold,
                 int numThreads, octi::ilp::ILPStats* stats,
-                const std::string& solverStr, const std::string& path);
+                const std::string& solverStr, const std::string& path,
+                double corridorWidth, size_t corridorIters);
 
   size_t maxNodeDeg() const;
 
  private:
   basegraph::BaseGraphType _baseGraphType;
+  basegraph::PQType _pqType;
+
+  // directory built base graphs are stored in and loaded from, empty if
+  // base graphs are always built from scratch
+  std::string _gridCacheDir;
+
+  // number of landmarks for the ALT heuristic, 0 if not used
+  size_t _numLandmarks;
+
+  // number of coarser grids the heuristic is first solved on, each with twice
+  // the cell size of the next finer one. The finer grid only covers the
+  // cells at most _coarseCorridor coarse cells away from the coarse drawing.
+  size_t _coarseLevels;
+  size_t _coarseCorridor;
+
+  // if set, octilinear grids are only built inside this corridor
+  const basegraph::GridCorridor* _corridor;
+
+  // geo course penalties are only recomputed if the grid they were written
+  // for changes
+  struct GeoPensKey {
+    const CombGraph* cg = 0;
+    util::geo::DBox box;
+    double gridSize = 0, borderRad = 0, pen = 0;
+    size_t hananIters = 0;
+  };
+  GeoPensKey _geoPensKey;
+  GeoPensMap _geoPens;
+  bool _hasGeoPens = false;
+
+  const GeoPensMap* geoPens(const CombGraph& cg, const basegraph::BaseGraph* gg,
+                            const util::geo::DBox& box, double gridSize,
+                            double borderRad, size_t hananIters, double pen,
+                            size_t jobs);
 
   basegraph::BaseGraph* newBaseGraph(const util::geo::DBox& bbox,
                                      const CombGraph& cg, double cellSize,
                                      double spacer, size_t hananIters,
                                      const Penalties& pens) const;
 
+  // a new initialized base graph, loaded from the grid cache if possible
+  basegraph::BaseGraph* initBaseGraph(const util::geo::DBox& bbox,
+                                      const CombGraph& cg, double cellSize,
+                                      double spacer, size_t hananIters,
+                                      const Penalties& pens) const;
+
+  uint64_t gridCacheKey(const util::geo::DBox& bbox, double cellSize,
+                        double spacer, size_t hananIters,
+                        const Penalties& pens) const;
+
   util::geo::Polygon<double> hull(const CombGraph& cg) const;
 
   void writeNdCosts(GridNode* n, CombNode* origNode, CombEdge* e,
@@ -218,11 +311,30 @@ class Octilinearizer {
 
   Undrawable draw(const std::vector<CombEdge*>& order, basegraph::BaseGraph* gg,
                   Drawing* drawing, double cutoff, double maxGrDist,
-                  const GeoPensMap* geoPensMap, size_t abortAfter);
+                  const GeoPensMap* geoPensMap, size_t abortAfter,
+                  GridDijkstra* search);
   Undrawable draw(const std::vector<CombEdge*>& order,
                   const SettledPos& settled, basegraph::BaseGraph* gg,
                   Drawing* drawing, double cutoff, double maxGrDist,
-                  const GeoPensMap* geoPensMap, size_t abortAfter);
+                  const GeoPensMap* geoPensMap, size_t abortAfter,
+                  GridDijkstra* search);
+
+  // grid positions for the comb nodes whose stations are part of the
+  // previous layout, and which did not move by more than maxGrDist cells
+  SettledPos warmStartPos(const CombGraph& cg, const basegraph::BaseGraph* gg,
+                          const PrevLayout& prevLayout,
+                          double maxGrDist) const;
+
+  // move each comb node nds[i] with pos[i] != 0 to grid node pos[i], where
+  // scores[i] is the score this was found to give in isolation. Moves are
+  // tried best first, and skipped if they conflict with an already committed
+  // move. Returns the number of committed moves.
+  size_t applyMoves(const std::vector<CombNode*>& nds,
+                    const std::vector<GridNode*>& pos,
+                    const std::vector<double>& scores,
+                    basegraph::BaseGraph* gg, Drawing* drawing,
+                    double maxGrDist, const GeoPensMap* geoPens,
+                    GridDijkstra* search);
 
   SettledPos neigh(const SettledPos& pos, const std::vector<CombNode*>&,
                    size_t i) const;
@@ -4,9 +4,12 @@
 #ifndef OCTI_BASEGRAPH_BASEGRAPH_H_
 #define OCTI_BASEGRAPH_BASEGRAPH_H_
 
+#include <cstdint>
+#include <iosfwd>
 #include <queue>
 #include <set>
 #include <unordered_map>
+#include "octi/basegraph/GeoPens.h"
 #include "octi/basegraph/GridEdgePL.h"
 #include "octi/basegraph/GridNodePL.h"
 #include "octi/basegraph/NodeCost.h"
@@ -49,9 +52,6 @@ typedef util::graph::Edge<GridNodePL, GridEdgePL> GridEdge;
 typedef std::pair<const GridEdge*, const GridEdge*> EdgPair;
 typedef std::vector<std::pair<EdgPair, EdgPair>> CrossEdgPairs;
 
-// edge-id -> pen
-typedef std::unordered_map<uint32_t, float> GeoPens;
-typedef std::map<const CombEdge*, GeoPens> GeoPensMap;
 
 struct Candidate {
   Candidate(GridNode* n, double d) : n(n), d(d){};
@@ -79,6 +79,15 @@ class BaseGraph : public DirGraph<GridNodePL, GridEdgePL> {
   BaseGraph(){};
 
   virtual void init() = 0;
+
+  // write the graph as built by init() to out, tagged with key. Returns
+  // false if this is not supported by the graph.
+  virtual bool writeCache(std::ostream* out, uint64_t key) const = 0;
+
+  // build the graph from a cache written by writeCache() instead of calling
+  // init(). Returns false and leaves the graph untouched if the cache was
+  // not written for this graph and key.
+  virtual bool initFromCache(std::istream* in, uint64_t key) = 0;
   virtual double getCellSize() const = 0;
 
   virtual NodeCost nodeBendPen(GridNode* n, CombNode* origNode,
@@ -138,12 +147,17 @@ class BaseGraph : public DirGraph<GridNodePL, GridEdgePL> {
   virtual std::set<CombEdge*> getResEdgs(const GridEdge* ge) const = 0;
   virtual std::set<CombEdge*> getResEdgsDirInd(const GridEdge* ge) const = 0;
 
-  virtual void writeGeoCoursePens(const CombEdge* ce, GeoPensMap* target,
-                                  double pen) = 0;
+  virtual void writeGeoCoursePens(const CombEdge* ce, GeoPensRow* target,
+                                  double pen) const = 0;
 
   virtual CrossEdgPairs getCrossEdgPairs() const = 0;
 
   virtual void addObstacle(const util::geo::Polygon<double>& obst) = 0;
+
+  // precompute distances from num landmarks under the current (static) edge
+  // costs, to be used for tighter heuristics by getHeur(). 0 disables them.
+  virtual void writeLandmarks(size_t num) = 0;
+
   virtual PolyLine<double> geomFromPath(
       const std::vector<std::pair<size_t, size_t>>& res) const = 0;
 };
@@ -22,6 +22,9 @@ class ConvexHullOctiGridGraph : public OctiGridGraph {
   virtual void init();
 
  protected:
+  // built by init() only, see GridGraph::writeCache()
+  virtual bool cacheable() const { return false; }
+
   virtual bool skip(size_t x, size_t y) const;
   virtual GridNode* writeNd(size_t x, size_t y);
   virtual GridNode* getNode(size_t x, size_t y) const;
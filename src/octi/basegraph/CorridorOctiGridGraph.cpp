@@ -0,0 +1,14 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include "octi/basegraph/CorridorOctiGridGraph.h"
+
+using octi::basegraph::CorridorOctiGridGraph;
+
+// _____________________________________________________________________________
+bool CorridorOctiGridGraph::skip(size_t x, size_t y) const {
+  double xPos = _bbox.getLowerLeft().getX() + x * _cellSize;
+  double yPos = _bbox.getLowerLeft().getY() + y * _cellSize;
+  return !_corridor.contains({xPos, yPos});
+}
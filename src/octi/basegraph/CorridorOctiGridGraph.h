@@ -0,0 +1,33 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef OCTI_BASEGRAPH_CORRIDOROCTIGRIDGRAPH_H_
+#define OCTI_BASEGRAPH_CORRIDOROCTIGRIDGRAPH_H_
+
+#include "octi/basegraph/ConvexHullOctiGridGraph.h"
+#include "octi/basegraph/GridCorridor.h"
+
+namespace octi {
+namespace basegraph {
+
+// An octilinear grid graph which only has nodes inside a corridor, built the
+// same way as ConvexHullOctiGridGraph does for its hull.
+class CorridorOctiGridGraph : public ConvexHullOctiGridGraph {
+ public:
+  CorridorOctiGridGraph(const GridCorridor& corridor,
+                        const util::geo::DBox& bbox, double cellSize,
+                        double spacer, const Penalties& pens)
+      : ConvexHullOctiGridGraph(DPolygon(), bbox, cellSize, spacer, pens),
+        _corridor(corridor) {}
+
+ protected:
+  virtual bool skip(size_t x, size_t y) const;
+
+ private:
+  GridCorridor _corridor;
+};
+}  // namespace basegraph
+}  // namespace octi
+
+#endif  // OCTI_BASEGRAPH_CORRIDOROCTIGRIDGRAPH_H_
@@ -0,0 +1,46 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include "octi/basegraph/GeoPens.h"
+
+using octi::basegraph::GeoPens;
+using octi::basegraph::GeoPensMap;
+using octi::basegraph::GeoPensRow;
+
+// _____________________________________________________________________________
+bool GeoPens::get(uint32_t id, float* pen) const {
+  const uint32_t* i = std::lower_bound(ids, ids + size, id);
+  if (i == ids + size || *i != id) return false;
+  *pen = pens[i - ids];
+  return true;
+}
+
+// _____________________________________________________________________________
+GeoPensMap::GeoPensMap(std::vector<GeoPensRow>* rows) : _offsets(1, 0) {
+  size_t tot = 0;
+  for (const auto& r : *rows) tot += r.size();
+
+  _offsets.reserve(rows->size() + 1);
+  _ids.reserve(tot);
+  _pens.reserve(tot);
+
+  for (auto& r : *rows) {
+    std::sort(r.begin(), r.end());
+    for (const auto& p : r) {
+      _ids.push_back(p.first);
+      _pens.push_back(p.second);
+    }
+    _offsets.push_back(_ids.size());
+    GeoPensRow().swap(r);
+  }
+}
+
+// _____________________________________________________________________________
+GeoPens GeoPensMap::row(size_t combEdgId) const {
+  if (combEdgId + 1 >= _offsets.size()) return {0, 0, 0};
+  size_t beg = _offsets[combEdgId];
+  return {_ids.data() + beg, _pens.data() + beg,
+          _offsets[combEdgId + 1] - beg};
+}
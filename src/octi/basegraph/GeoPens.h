@@ -0,0 +1,51 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef OCTI_BASEGRAPH_GEOPENS_H_
+#define OCTI_BASEGRAPH_GEOPENS_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace octi {
+namespace basegraph {
+
+// (grid edge id, pen) pairs of a single comb edge, in any order
+typedef std::vector<std::pair<uint32_t, float>> GeoPensRow;
+
+// read-only view on the geo course penalties of a single comb edge, sorted
+// by grid edge id
+struct GeoPens {
+  const uint32_t* ids;
+  const float* pens;
+  size_t size;
+
+  // the penalty for grid edge id, false if none is present
+  bool get(uint32_t id, float* pen) const;
+};
+
+// geo course penalties of all comb edges, indexed by comb edge id (see
+// CombGraph::writeIds()) and held in compressed sparse row form
+class GeoPensMap {
+ public:
+  GeoPensMap() : _offsets(1, 0) {}
+
+  // build from one row per comb edge id, rows are consumed
+  explicit GeoPensMap(std::vector<GeoPensRow>* rows);
+
+  GeoPens row(size_t combEdgId) const;
+
+  size_t numRows() const { return _offsets.size() - 1; }
+  size_t size() const { return _ids.size(); }
+
+ private:
+  std::vector<size_t> _offsets;
+  std::vector<uint32_t> _ids;
+  std::vector<float> _pens;
+};
+}  // namespace basegraph
+}  // namespace octi
+
+#endif  // OCTI_BASEGRAPH_GEOPENS_H_
@@ -0,0 +1,71 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <cmath>
+#include "octi/basegraph/GridCorridor.h"
+
+using octi::basegraph::GridCorridor;
+using util::geo::DBox;
+using util::geo::DPoint;
+
+// _____________________________________________________________________________
+GridCorridor::GridCorridor(const DBox& bbox, double cellSize)
+    : _bbox(bbox), _cellSize(cellSize), _size(0) {
+  _xWidth = std::ceil((bbox.getUpperRight().getX() -
+                       bbox.getLowerLeft().getX()) / cellSize) + 1;
+  _yHeight = std::ceil((bbox.getUpperRight().getY() -
+                        bbox.getLowerLeft().getY()) / cellSize) + 1;
+  _cells.resize(_xWidth * _yHeight, 0);
+}
+
+// _____________________________________________________________________________
+bool GridCorridor::cell(const DPoint& p, int64_t* x, int64_t* y) const {
+  *x = std::floor((p.getX() - _bbox.getLowerLeft().getX()) / _cellSize);
+  *y = std::floor((p.getY() - _bbox.getLowerLeft().getY()) / _cellSize);
+  return *x >= 0 && *y >= 0 && *x < static_cast<int64_t>(_xWidth) &&
+         *y < static_cast<int64_t>(_yHeight);
+}
+
+// _____________________________________________________________________________
+void GridCorridor::add(const DPoint& p, size_t rad) {
+  int64_t cx, cy;
+  cell(p, &cx, &cy);
+
+  int64_t r = rad;
+  for (int64_t x = std::max<int64_t>(0, cx - r);
+       x <= std::min<int64_t>(_xWidth - 1, cx + r); x++) {
+    for (int64_t y = std::max<int64_t>(0, cy - r);
+         y <= std::min<int64_t>(_yHeight - 1, cy + r); y++) {
+      auto& c = _cells[x * _yHeight + y];
+      if (!c) _size++;
+      c = 1;
+    }
+  }
+}
+
+// _____________________________________________________________________________
+void GridCorridor::add(const util::geo::Line<double>& l, size_t rad) {
+  for (size_t i = 0; i < l.size(); i++) {
+    add(l[i], rad);
+    if (i + 1 == l.size()) break;
+
+    // sample the segment at half the cell size, to not skip any cell
+    double d = util::geo::dist(l[i], l[i + 1]);
+    size_t steps = std::ceil(d / (_cellSize / 2));
+    for (size_t j = 1; j < steps; j++) {
+      double t = static_cast<double>(j) / steps;
+      add(DPoint(l[i].getX() + t * (l[i + 1].getX() - l[i].getX()),
+                 l[i].getY() + t * (l[i + 1].getY() - l[i].getY())),
+          rad);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+bool GridCorridor::contains(const DPoint& p) const {
+  int64_t x, y;
+  if (!cell(p, &x, &y)) return false;
+  return _cells[x * _yHeight + y];
+}
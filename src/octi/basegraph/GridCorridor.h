@@ -0,0 +1,44 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef OCTI_BASEGRAPH_GRIDCORRIDOR_H_
+#define OCTI_BASEGRAPH_GRIDCORRIDOR_H_
+
+#include <cstdint>
+#include <vector>
+#include "util/geo/Geo.h"
+
+namespace octi {
+namespace basegraph {
+
+// A set of cells of a regular grid over a bounding box, used to restrict
+// a finer grid graph to the area around a coarse solution.
+class GridCorridor {
+ public:
+  GridCorridor(const util::geo::DBox& bbox, double cellSize);
+
+  // add the cell containing p, and all cells at most rad cells away
+  void add(const util::geo::DPoint& p, size_t rad);
+
+  // add all cells l passes through, and all cells at most rad cells away
+  void add(const util::geo::Line<double>& l, size_t rad);
+
+  bool contains(const util::geo::DPoint& p) const;
+
+  // number of cells in the corridor, and in total
+  size_t size() const { return _size; }
+  size_t numCells() const { return _cells.size(); }
+
+ private:
+  util::geo::DBox _bbox;
+  double _cellSize;
+  size_t _xWidth, _yHeight, _size;
+  std::vector<uint8_t> _cells;
+
+  bool cell(const util::geo::DPoint& p, int64_t* x, int64_t* y) const;
+};
+}  // namespace basegraph
+}  // namespace octi
+
+#endif  // OCTI_BASEGRAPH_GRIDCORRIDOR_H_
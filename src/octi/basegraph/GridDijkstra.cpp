@@ -0,0 +1,185 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include "octi/basegraph/GridDijkstra.h"
+
+using octi::basegraph::BaseGraph;
+using octi::basegraph::GridCostFunc;
+using octi::basegraph::GridDijkstra;
+using octi::basegraph::GridHeurFunc;
+using octi::basegraph::GridNode;
+
+// _____________________________________________________________________________
+GridDijkstra::GridDijkstra(const BaseGraph* g, PQType pqType)
+    : _pqType(pqType), _epoch(0) {
+  _labels.resize(g->getNds().size(), Label{0, 0, 0, 0, 0});
+}
+
+// _____________________________________________________________________________
+GridDijkstra::Label& GridDijkstra::label(const GridNode* n) {
+  size_t id = n->pl().getId();
+  if (id >= _labels.size()) {
+    _labels.resize(id + 1 + id / 2, Label{0, 0, 0, 0, 0});
+  }
+  return _labels[id];
+}
+
+// _____________________________________________________________________________
+uint32_t GridDijkstra::key(float f) {
+  // for non-negative floats, the bit patterns order like the values
+  if (f == 0) return 0;
+  uint32_t k;
+  std::memcpy(&k, &f, sizeof(k));
+  return k;
+}
+
+// _____________________________________________________________________________
+size_t GridDijkstra::bucket(uint32_t k) const {
+  if (k == _last) return 0;
+  return 32 - __builtin_clz(k ^ _last);
+}
+
+// _____________________________________________________________________________
+void GridDijkstra::toBinary() {
+  for (auto& b : _buckets) {
+    _heap.insert(_heap.end(), b.begin(), b.end());
+    b.clear();
+  }
+  std::make_heap(_heap.begin(), _heap.end(), std::greater<HeapEntry>());
+  _radixSize = 0;
+  _radix = false;
+  _numFallbacks++;
+}
+
+// _____________________________________________________________________________
+bool GridDijkstra::empty() const {
+  if (_radix) return _radixSize == 0;
+  return _heap.empty();
+}
+
+// _____________________________________________________________________________
+void GridDijkstra::push(float f, float d, GridNode* n) {
+  if (_radix) {
+    // keys below the last minimum violate the radix heap invariant
+    if (f >= 0 && key(f) >= _last) {
+      _buckets[bucket(key(f))].push_back({f, d, n});
+      _radixSize++;
+      return;
+    }
+    toBinary();
+  }
+
+  _heap.push_back({f, d, n});
+  std::push_heap(_heap.begin(), _heap.end(), std::greater<HeapEntry>());
+}
+
+// _____________________________________________________________________________
+GridDijkstra::HeapEntry GridDijkstra::pop() {
+  if (_radix) {
+    if (_buckets[0].empty()) {
+      size_t i = 1;
+      while (_buckets[i].empty()) i++;
+
+      // the smallest key in the first non-empty bucket becomes the new
+      // minimum, all other keys of that bucket move to lower buckets
+      _last = key(_buckets[i].front().f);
+      for (const auto& e : _buckets[i]) _last = std::min(_last, key(e.f));
+      for (const auto& e : _buckets[i]) {
+        _buckets[bucket(key(e.f))].push_back(e);
+      }
+      _buckets[i].clear();
+    }
+
+    HeapEntry ret = _buckets[0].back();
+    _buckets[0].pop_back();
+    _radixSize--;
+    return ret;
+  }
+
+  std::pop_heap(_heap.begin(), _heap.end(), std::greater<HeapEntry>());
+  HeapEntry ret = _heap.back();
+  _heap.pop_back();
+  return ret;
+}
+
+// _____________________________________________________________________________
+float GridDijkstra::shortestPath(
+    const std::set<GridNode*>& from, const std::set<GridNode*>& to,
+    const GridCostFunc& cost, const GridHeurFunc& heur,
+    util::graph::EList<GridNodePL, GridEdgePL>* eL,
+    util::graph::NList<GridNodePL, GridEdgePL>* nL) {
+  // on overflow, invalidate all labels once
+  if (++_epoch == 0) {
+    for (auto& l : _labels) l.reached = l.settled = l.target = 0;
+    _epoch = 1;
+  }
+
+  _numSearches++;
+
+  // keeps the capacity of the last search
+  _heap.clear();
+  for (auto& b : _buckets) b.clear();
+  _radixSize = 0;
+  _last = 0;
+  _radix = _pqType == RADIX;
+
+  for (auto n : to) label(n).target = _epoch;
+
+  for (auto n : from) {
+    auto& l = label(n);
+    l.reached = _epoch;
+    l.d = 0;
+    l.e = 0;
+    push(heur(n, to), 0, n);
+  }
+
+  GridNode* found = 0;
+
+  while (!empty()) {
+    auto cur = pop();
+    auto& l = label(cur.n);
+
+    if (l.settled == _epoch || cur.d > l.d) continue;
+    l.settled = _epoch;
+
+    if (l.target == _epoch) {
+      found = cur.n;
+      break;
+    }
+
+    for (auto e : cur.n->getAdjListOut()) {
+      GridNode* t = e->getTo();
+      auto& tl = label(t);
+      if (tl.settled == _epoch) continue;
+
+      float d = cur.d + cost(cur.n, e, t);
+      if (d >= cost.inf()) continue;
+
+      if (tl.reached != _epoch || d < tl.d) {
+        tl.reached = _epoch;
+        tl.d = d;
+        tl.e = e;
+        push(d + heur(t, to), d, t);
+      }
+    }
+  }
+
+  if (!found) return std::numeric_limits<float>::infinity();
+
+  // build the path, target first
+  GridNode* n = found;
+  while (true) {
+    nL->push_back(n);
+    GridEdge* e = label(n).e;
+    if (!e) break;
+    eL->push_back(e);
+    n = e->getFrom();
+  }
+
+  return label(found).d;
+}
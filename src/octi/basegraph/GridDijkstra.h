@@ -0,0 +1,100 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef OCTI_BASEGRAPH_GRIDDIJKSTRA_H_
+#define OCTI_BASEGRAPH_GRIDDIJKSTRA_H_
+
+#include <cstdint>
+#include <set>
+#include <vector>
+#include "octi/basegraph/BaseGraph.h"
+#include "util/graph/Dijkstra.h"
+
+namespace octi {
+namespace basegraph {
+
+typedef util::graph::Dijkstra::CostFunc<GridNodePL, GridEdgePL, float>
+    GridCostFunc;
+typedef util::graph::Dijkstra::HeurFunc<GridNodePL, GridEdgePL, float>
+    GridHeurFunc;
+
+// priority queue used by the search, see GridDijkstra
+enum PQType { BINARY = 0, RADIX = 1 };
+
+// Reusable shortest path search on a grid graph. All labels are held in
+// arrays indexed by GridNodePL::getId() and are only valid if stamped with
+// the current search epoch, so nothing has to be allocated or cleared between
+// two searches. A workspace must not be shared between threads.
+//
+// With PQType::RADIX, a radix heap is used as the priority queue. Keys are
+// the bit patterns of the (non-negative) float priorities, which order the
+// same as the floats themselves, so no quantisation of costs is needed and
+// the search stays exact. A radix heap requires monotone keys, which A* with
+// a consistent heuristic guarantees. If a key smaller than the last extracted
+// minimum is ever pushed (e.g. because of float rounding in the heuristic),
+// the search falls back to a binary heap for its remainder.
+class GridDijkstra {
+ public:
+  GridDijkstra() : _pqType(BINARY), _epoch(0) {}
+  GridDijkstra(const BaseGraph* g, PQType pqType);
+
+  // same semantics as util::graph::Dijkstra::shortestPath(), that is, edges
+  // and nodes of the found path are written to eL and nL in reverse order
+  // (target first), and edges whose cost reaches cost.inf() are not taken.
+  float shortestPath(const std::set<GridNode*>& from,
+                     const std::set<GridNode*>& to, const GridCostFunc& cost,
+                     const GridHeurFunc& heur,
+                     util::graph::EList<GridNodePL, GridEdgePL>* eL,
+                     util::graph::NList<GridNodePL, GridEdgePL>* nL);
+
+  // number of searches, and number of searches that fell back to the binary
+  // heap
+  size_t numSearches() const { return _numSearches; }
+  size_t numFallbacks() const { return _numFallbacks; }
+
+ private:
+  struct Label {
+    uint32_t reached;
+    uint32_t settled;
+    uint32_t target;
+    float d;
+    GridEdge* e;
+  };
+
+  struct HeapEntry {
+    float f;
+    float d;
+    GridNode* n;
+    bool operator>(const HeapEntry& o) const { return f > o.f; }
+  };
+
+  PQType _pqType;
+
+  std::vector<Label> _labels;
+  std::vector<HeapEntry> _heap;
+  uint32_t _epoch;
+
+  // radix heap state, bucket i > 0 holds keys whose highest bit differing
+  // from _last is bit i - 1
+  bool _radix = false;
+  std::vector<HeapEntry> _buckets[33];
+  uint32_t _last = 0;
+  size_t _radixSize = 0;
+
+  size_t _numSearches = 0;
+  size_t _numFallbacks = 0;
+
+  Label& label(const GridNode* n);
+  void push(float f, float d, GridNode* n);
+  HeapEntry pop();
+  bool empty() const;
+
+  static uint32_t key(float f);
+  size_t bucket(uint32_t key) const;
+  void toBinary();
+};
+}  // namespace basegraph
+}  // namespace octi
+
+#endif  // OCTI_BASEGRAPH_GRIDDIJKSTRA_H_
@@ -12,24 +12,39 @@ using namespace octi::basegraph;
 
 // _____________________________________________________________________________
 GridEdgePL::GridEdgePL(double c, bool secondary, bool sink)
-    : _c(c),
-      _isSecondary(secondary),
-      _isSink(sink),
-      _closed(false),
-      _softClosed(false),
-      _blocked(false),
-      _resEdgs(0) {}
+    : _isSecondary(secondary), _isSink(sink) {
+  _st.c = c;
+  _st.closed = false;
+  _st.softClosed = false;
+  _st.blocked = false;
+  _st.resEdgs = 0;
+}
+
+// _____________________________________________________________________________
+const GridEdgeState& GridEdgePL::st() const {
+  auto o = GridOverlay::cur();
+  if (o) return o->edg(_id, _st);
+  return _st;
+}
+
+// _____________________________________________________________________________
+GridEdgeState& GridEdgePL::mutSt() {
+  auto o = GridOverlay::cur();
+  if (o) return o->mutEdg(_id, _st);
+  return _st;
+}
 
 // _____________________________________________________________________________
 const util::geo::Line<double>* GridEdgePL::getGeom() const { return 0; }
 
 // _____________________________________________________________________________
-size_t GridEdgePL::resEdgs() const { return _resEdgs; }
+size_t GridEdgePL::resEdgs() const { return st().resEdgs; }
 
 // _____________________________________________________________________________
 void GridEdgePL::reset() {
-  _closed = false;
-  _resEdgs = 0;
+  auto& s = mutSt();
+  s.closed = false;
+  s.resEdgs = 0;
 }
 
 // _____________________________________________________________________________
@@ -38,65 +53,69 @@ util::json::Dict GridEdgePL::getAttrs() const {
   obj["cost"] = cost() == std::numeric_limits<double>::infinity()
                     ? "inf"
                     : util::toString(cost());
-  obj["res_edges"] = util::toString((int)_resEdgs);
+  obj["res_edges"] = util::toString((int)st().resEdgs);
   obj["secondary"] = util::toString((int)_isSecondary);
   obj["sink"] = util::toString((int)_isSink);
-  obj["closed"] = util::toString(_closed);
-  obj["blocked"] = util::toString(_blocked);
-  obj["softclosed"] = util::toString(_softClosed);
+  obj["closed"] = util::toString(st().closed);
+  obj["blocked"] = util::toString(st().blocked);
+  obj["softclosed"] = util::toString(st().softClosed);
   return obj;
 }
 // _____________________________________________________________________________
 double GridEdgePL::cost() const {
   // testing relaxed constraints for diagonal intersections
-  if (_softClosed || _blocked) return SOFT_INF + rawCost();
-  if (_closed) return INF;
+  const auto& s = st();
+  if (s.softClosed || s.blocked) return SOFT_INF + s.c;
+  if (s.closed) return INF;
 
-  return rawCost();
+  return s.c;
 }
 
 // _____________________________________________________________________________
-double GridEdgePL::rawCost() const { return _c; }
+double GridEdgePL::rawCost() const { return st().c; }
 
 // _____________________________________________________________________________
-void GridEdgePL::addResEdge() { _resEdgs++; }
+void GridEdgePL::addResEdge() { mutSt().resEdgs++; }
 
 // _____________________________________________________________________________
 void GridEdgePL::close() {
-  _closed = true;
-  _softClosed = false;
+  auto& s = mutSt();
+  s.closed = true;
+  s.softClosed = false;
 }
 
 // _____________________________________________________________________________
 void GridEdgePL::softClose() {
-  if (!_closed) _softClosed = true;
-  _closed = true;
+  auto& s = mutSt();
+  if (!s.closed) s.softClosed = true;
+  s.closed = true;
 }
 
 // _____________________________________________________________________________
-bool GridEdgePL::closed() const { return _closed; }
+bool GridEdgePL::closed() const { return st().closed; }
 
 // _____________________________________________________________________________
 void GridEdgePL::open() {
-  _closed = false;
-  _softClosed = false;
+  auto& s = mutSt();
+  s.closed = false;
+  s.softClosed = false;
 }
 
 // _____________________________________________________________________________
-void GridEdgePL::block() { _blocked = true; }
+void GridEdgePL::block() { mutSt().blocked = true; }
 
 // _____________________________________________________________________________
-void GridEdgePL::unblock() { _blocked = false; }
+void GridEdgePL::unblock() { mutSt().blocked = false; }
 
 // _____________________________________________________________________________
-void GridEdgePL::setCost(double c) { _c = c; }
+void GridEdgePL::setCost(double c) { mutSt().c = c; }
 
 // _____________________________________________________________________________
 bool GridEdgePL::isSecondary() const { return _isSecondary; }
 
 // _____________________________________________________________________________
 void GridEdgePL::delResEdg() {
-  if (_resEdgs > 0) _resEdgs--;
+  if (st().resEdgs > 0) mutSt().resEdgs--;
 }
 
 // _____________________________________________________________________________
@@ -104,3 +123,9 @@ void GridEdgePL::setId(size_t id) { _id = id; }
 
 // _____________________________________________________________________________
 size_t GridEdgePL::getId() const { return _id; }
+
+// _____________________________________________________________________________
+const GridEdgeState& GridEdgePL::getState() const { return st(); }
+
+// _____________________________________________________________________________
+void GridEdgePL::setState(const GridEdgeState& s) { mutSt() = s; }
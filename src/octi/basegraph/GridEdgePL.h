@@ -5,6 +5,7 @@
 #define OCTI_BASEGRAPH_GRIDEDGEPL_H_
 
 #include <set>
+#include "octi/basegraph/GridOverlay.h"
 #include "octi/combgraph/CombEdgePL.h"
 #include "octi/combgraph/CombNodePL.h"
 #include "util/geo/GeoGraph.h"
@@ -46,20 +47,20 @@ class GridEdgePL : util::geograph::GeoEdgePL<double> {
   void setId(size_t id);
   size_t getId() const;
 
+  // the complete mutable state, used to store and restore built graphs
+  const GridEdgeState& getState() const;
+  void setState(const GridEdgeState& s);
+
  private:
-  float _c;
+  // state as seen by the current thread, see GridOverlay
+  const GridEdgeState& st() const;
+  GridEdgeState& mutSt();
+
+  GridEdgeState _st;
 
   bool _isSecondary : 1;
   bool _isSink : 1;
 
-  bool _closed : 1;
-  bool _softClosed : 1;
-
-  // edges are blocked if they would cross a settled edge
-  bool _blocked : 1;
-
-  uint8_t _resEdgs : 8;
-
   uint32_t _id;
 };
 }
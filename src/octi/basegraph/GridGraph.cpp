@@ -3,6 +3,7 @@
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <unordered_map>
 #include <unordered_set>
@@ -26,6 +27,34 @@ using util::geo::DPoint;
 using util::geo::intersects;
 using util::geo::LineSegment;
 
+namespace {
+// on-disk layout of a built grid graph, see GridGraph::writeCache(). All
+// records have a fixed size, so the node and edge sections can be read in
+// one go (or be mapped into memory).
+const char CACHE_MAGIC[8] = {'O', 'C', 'T', 'I', 'G', 'G', '0', '1'};
+const uint32_t CACHE_NONE = std::numeric_limits<uint32_t>::max();
+
+struct CacheHeader {
+  char magic[8];
+  uint64_t key;
+  uint64_t numNdIds, numNds, numEdgs, edgeCount;
+  uint64_t xWidth, yHeight;
+};
+
+struct CacheNd {
+  double x, y;
+  uint32_t id, parent, gridX, gridY;
+  uint32_t ports[8];
+  uint8_t sink, closed, settled, pad;
+};
+
+struct CacheEdg {
+  uint32_t id, from, to;
+  float c;
+  uint8_t secondary, sink, closed, softClosed, blocked, resEdgs, pad[2];
+};
+}  // namespace
+
 // _____________________________________________________________________________
 GridGraph::GridGraph(const DBox& bbox, double cellSize, double spacer,
                      const Penalties& pens)
@@ -34,7 +63,8 @@ GridGraph::GridGraph(const DBox& bbox, double cellSize, double spacer,
       _grid(cellSize, cellSize, bbox, false),
       _cellSize(cellSize),
       _spacer(spacer),
-      _edgeCount(0) {
+      _edgeCount(0),
+      _maxNEdgLen(-1) {
   assert(_c.p_0 <= _c.p_135);
   assert(_c.p_135 <= _c.p_90);
   assert(_c.p_90 <= _c.p_45);
@@ -117,9 +147,10 @@ GridNode* GridGraph::neigh(const GridNode* n, size_t i) const {
 
 // _____________________________________________________________________________
 void GridGraph::unSettleNd(CombNode* a) {
-  openTurns(_settled[a]);
-  _settled[a]->pl().setSettled(false);
-  _settled.erase(a);
+  auto& settled = settledMap();
+  openTurns(settled[a]);
+  settled[a]->pl().setSettled(false);
+  settled.erase(a);
 }
 
 // _____________________________________________________________________________
@@ -136,10 +167,10 @@ void GridGraph::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
   ge->pl().delResEdg();
   gf->pl().delResEdg();
 
-  _resEdgs[ge].erase(ce);
-  _resEdgs[gf].erase(ce);
+  delResEdg(ge, ce);
+  delResEdg(gf, ce);
 
-  if (_resEdgs[ge].size() == 0) {
+  if (!hasResEdgs(ge)) {
     if (!a->pl().isSettled() && unused(a)) openTurns(a);
     if (!b->pl().isSettled() && unused(b)) openTurns(b);
   }
@@ -154,35 +185,65 @@ void GridGraph::addObstacle(const util::geo::Polygon<double>& obst) {
   writeObstacleCost(obst);
 }
 
+// _____________________________________________________________________________
+double GridGraph::maxNEdgLen() const {
+  double ret = 0;
+  for (auto grNdA : _nds) {
+    if (!grNdA || !grNdA->pl().isSink()) continue;
+    for (size_t i = 0; i < maxDeg(); i++) {
+      auto grNeigh = neigh(grNdA->pl().getX(), grNdA->pl().getY(), i);
+      if (!grNeigh) continue;
+      auto ge = getNEdg(grNdA, grNeigh);
+      if (!ge) continue;
+      ret = std::max(ret, dist(*ge->getFrom()->pl().getGeom(),
+                               *ge->getTo()->pl().getGeom()));
+    }
+  }
+  return ret;
+}
+
 // _____________________________________________________________________________
 void GridGraph::writeObstacleCost(const util::geo::Polygon<double>& obst) {
-  for (size_t x = 0; x < _grid.getXWidth(); x++) {
-    for (size_t y = 0; y < _grid.getYHeight(); y++) {
-      auto grNdA = getNode(x, y);
+  // an edge can only hit the obstacle if one of its ends lies within one
+  // edge length of the obstacle's bounding box, so only the grid nodes
+  // found there in the grid index have to be checked
+  if (_maxNEdgLen < 0) _maxNEdgLen = maxNEdgLen();
 
-      for (size_t i = 0; i < maxDeg(); i++) {
-        auto grNeigh = neigh(x, y, i);
-        if (!grNeigh) continue;
-        auto ge = getNEdg(grNdA, grNeigh);
-
-        if (!ge) continue;
-
-        if (intersects(LineSegment<double>(*ge->getFrom()->pl().getGeom(),
-                                           *ge->getTo()->pl().getGeom()),
-                       obst) ||
-            contains(LineSegment<double>(*ge->getFrom()->pl().getGeom(),
-                                         *ge->getTo()->pl().getGeom()),
-                     obst)) {
-          ge->pl().setCost(std::numeric_limits<double>::infinity());
-        }
+  DBox obstBox = util::geo::extendBox(obst.getOuter(), DBox());
+
+  std::set<GridNode*> cands;
+  _grid.get(util::geo::pad(obstBox, _maxNEdgLen + _cellSize), &cands);
+
+  for (auto grNdA : cands) {
+    for (size_t i = 0; i < maxDeg(); i++) {
+      auto grNeigh = neigh(grNdA->pl().getX(), grNdA->pl().getY(), i);
+      if (!grNeigh) continue;
+      auto ge = getNEdg(grNdA, grNeigh);
+
+      if (!ge) continue;
+
+      const auto& a = *ge->getFrom()->pl().getGeom();
+      const auto& b = *ge->getTo()->pl().getGeom();
+
+      if (!util::geo::intersects(
+              util::geo::extendBox(b, util::geo::extendBox(a, DBox())),
+              obstBox)) {
+        continue;
+      }
+
+      LineSegment<double> seg(a, b);
+
+      if (intersects(seg, obst) || contains(seg, obst)) {
+        ge->pl().setCost(std::numeric_limits<double>::infinity());
+        _obstEdgs.push_back(ge);
       }
     }
   }
 }
 
 // _____________________________________________________________________________
-void GridGraph::writeGeoCoursePens(const CombEdge* ce, GeoPensMap* target,
-                                   double pen) {
+void GridGraph::writeGeoCoursePens(const CombEdge* ce, GeoPensRow* target,
+                                   double pen) const {
   std::set<GridNode*> neighs;
 
   DBox box;
@@ -221,7 +282,7 @@ void GridGraph::writeGeoCoursePens(const CombEdge* ce, GeoPensMap* target,
 
       d *= pen * d;
 
-      if (d <= SOFT_INF) (*target)[ce][ge->pl().getId()] = d;
+      if (d <= SOFT_INF) target->push_back({ge->pl().getId(), d});
     }
   }
 }
@@ -253,15 +314,16 @@ bool GridGraph::unused(const GridNode* gnd) const {
     if (!neighbor) continue;
     auto e = getNEdg(gnd, neighbor);
     auto f = getNEdg(neighbor, gnd);
-    auto a = _resEdgs.find(const_cast<GridEdge*>(e));
+    const auto& resEdgs = resEdgsMap();
+    auto a = resEdgs.find(const_cast<GridEdge*>(e));
 
-    if (a != _resEdgs.end()) {
+    if (a != resEdgs.end()) {
       assert(a->second.size() == e->pl().resEdgs());
     }
-    if (a != _resEdgs.end() && a->second.size() != 0) return false;
-    a = _resEdgs.find(const_cast<GridEdge*>(f));
-    if (a != _resEdgs.end()) assert(a->second.size() == f->pl().resEdgs());
-    if (a != _resEdgs.end() && a->second.size() != 0) return false;
+    if (a != resEdgs.end() && a->second.size() != 0) return false;
+    a = resEdgs.find(const_cast<GridEdge*>(f));
+    if (a != resEdgs.end()) assert(a->second.size() == f->pl().resEdgs());
+    if (a != resEdgs.end() && a->second.size() != 0) return false;
   }
   return true;
 }
@@ -269,15 +331,33 @@ bool GridGraph::unused(const GridNode* gnd) const {
 // _____________________________________________________________________________
 void GridGraph::addResEdg(GridEdge* ge, CombEdge* ce) {
   ge->pl().addResEdge();
-  _resEdgs[ge].insert(ce);
-  assert(_resEdgs[ge].size() == ge->pl().resEdgs());
+  auto& res = resEdgsMap()[ge];
+  res.insert(ce);
+  assert(res.size() == ge->pl().resEdgs());
+}
+
+// _____________________________________________________________________________
+void GridGraph::delResEdg(GridEdge* ge, CombEdge* ce) {
+  // remove empty entries, otherwise the map would grow with every grid edge
+  // ever touched during local search
+  auto& resEdgs = resEdgsMap();
+  auto it = resEdgs.find(ge);
+  if (it == resEdgs.end()) return;
+  it->second.erase(ce);
+  if (it->second.empty()) resEdgs.erase(it);
+}
+
+// _____________________________________________________________________________
+bool GridGraph::hasResEdgs(const GridEdge* ge) const {
+  return resEdgsMap().count(const_cast<GridEdge*>(ge));
 }
 
 // _____________________________________________________________________________
 std::set<CombEdge*> GridGraph::getResEdgs(const GridEdge* ge) const {
   if (!ge) return {};
-  if (_resEdgs.count(const_cast<GridEdge*>(ge)))
-    return _resEdgs.find(const_cast<GridEdge*>(ge))->second;
+  const auto& resEdgs = resEdgsMap();
+  auto it = resEdgs.find(const_cast<GridEdge*>(ge));
+  if (it != resEdgs.end()) return it->second;
   return {};
 }
 
@@ -286,13 +366,12 @@ std::set<CombEdge*> GridGraph::getResEdgsDirInd(const GridEdge* ge) const {
   std::set<CombEdge*> ret;
   if (!ge) return {};
   auto otherEdge = getEdg(ge->getTo(), ge->getFrom());
-  if (_resEdgs.count(const_cast<GridEdge*>(ge))) {
-    const auto& tmp = _resEdgs.find(const_cast<GridEdge*>(ge))->second;
-    ret.insert(tmp.begin(), tmp.end());
-  }
-  if (otherEdge && _resEdgs.count(const_cast<GridEdge*>(otherEdge))) {
-    const auto& tmp = _resEdgs.find(const_cast<GridEdge*>(otherEdge))->second;
-    ret.insert(tmp.begin(), tmp.end());
+  const auto& resEdgs = resEdgsMap();
+  auto it = resEdgs.find(const_cast<GridEdge*>(ge));
+  if (it != resEdgs.end()) ret.insert(it->second.begin(), it->second.end());
+  if (otherEdge) {
+    it = resEdgs.find(const_cast<GridEdge*>(otherEdge));
+    if (it != resEdgs.end()) ret.insert(it->second.begin(), it->second.end());
   }
   return ret;
 }
@@ -584,9 +663,19 @@ double GridGraph::heurCost(int64_t xa, int64_t ya, int64_t xb,
 // _____________________________________________________________________________
 const util::graph::Dijkstra::HeurFunc<GridNodePL, GridEdgePL, float>*
 GridGraph::getHeur(const std::set<GridNode*>& to) const {
+  if (_landmarks.size()) return new GridLandmarkHeur(this, &_landmarks, to);
   return new GridGraphHeur(this, to);
 }
 
+// _____________________________________________________________________________
+void GridGraph::writeLandmarks(size_t num) {
+  if (num == 0) {
+    _landmarks = GridLandmarks();
+    return;
+  }
+  _landmarks = GridLandmarks(this, num);
+}
+
 // _____________________________________________________________________________
 void GridGraph::openTurns(GridNode* n) {
   if (!n->pl().isClosed()) return;
@@ -669,8 +758,9 @@ void GridGraph::closeSinkFr(GridNode* n) {
 
 // _____________________________________________________________________________
 GridNode* GridGraph::getSettled(const CombNode* cnd) const {
-  auto i = _settled.find(cnd);
-  if (i != _settled.end()) return i->second;
+  const auto& settled = settledMap();
+  auto i = settled.find(cnd);
+  if (i != settled.end()) return i->second;
   return 0;
 }
 
@@ -695,7 +785,7 @@ std::set<GridNode*> GridGraph::getGrNdCands(CombNode* n, size_t maxDis) {
       cands.pop();
     }
   } else {
-    tos.insert(_settled.find(n)->second);
+    tos.insert(settledMap().find(n)->second);
   }
 
   return tos;
@@ -703,13 +793,13 @@ std::set<GridNode*> GridGraph::getGrNdCands(CombNode* n, size_t maxDis) {
 
 // _____________________________________________________________________________
 void GridGraph::settleNd(GridNode* n, CombNode* cn) {
-  _settled[cn] = n;
+  settledMap()[cn] = n;
   n->pl().setSettled(true);
 }
 
 // _____________________________________________________________________________
 bool GridGraph::isSettled(const CombNode* cn) {
-  return _settled.find(cn) != _settled.end();
+  return settledMap().count(cn);
 }
 
 // _____________________________________________________________________________
@@ -817,6 +907,13 @@ double GridGraph::ndMovePen(const CombNode* cbNd, const GridNode* grNd) const {
 
 // _____________________________________________________________________________
 void GridGraph::reset() {
+  // the base graph is never modified while an overlay is bound, so dropping
+  // the overlay's modifications restores the initial state
+  if (GridOverlay::cur()) {
+    GridOverlay::cur()->clear();
+    return;
+  }
+
   _settled.clear();
   _resEdgs.clear();
   for (auto n : getNds()) {
@@ -831,9 +928,207 @@ void GridGraph::reset() {
   reWriteObstCosts();
 }
 
+// _____________________________________________________________________________
+bool GridGraph::cacheable() const { return true; }
+
+// _____________________________________________________________________________
+bool GridGraph::writeCache(std::ostream* out, uint64_t key) const {
+  if (!cacheable()) return false;
+
+  std::vector<CacheNd> nds;
+  std::vector<CacheEdg> edgs;
+  nds.reserve(getNds().size());
+
+  for (auto n : getNds()) {
+    CacheNd r;
+    memset(&r, 0, sizeof(r));
+    r.x = n->pl().getGeom()->getX();
+    r.y = n->pl().getGeom()->getY();
+    r.id = n->pl().getId();
+    r.parent = n->pl().getParent() ? n->pl().getParent()->pl().getId()
+                                   : CACHE_NONE;
+    r.sink = n->pl().isSink();
+    r.closed = n->pl().isClosed();
+    r.settled = n->pl().isSettled();
+
+    for (size_t p = 0; p < 8; p++) r.ports[p] = CACHE_NONE;
+
+    if (r.sink) {
+      r.gridX = n->pl().getX();
+      r.gridY = n->pl().getY();
+      // pruned ports are 0
+      for (size_t p = 0; p < maxDeg(); p++) {
+        if (n->pl().getPort(p)) r.ports[p] = n->pl().getPort(p)->pl().getId();
+      }
+    }
+
+    nds.push_back(r);
+
+    for (auto e : n->getAdjListOut()) {
+      CacheEdg er;
+      memset(&er, 0, sizeof(er));
+      const auto& st = e->pl().getState();
+      er.id = e->pl().getId();
+      er.from = e->getFrom()->pl().getId();
+      er.to = e->getTo()->pl().getId();
+      er.c = st.c;
+      er.secondary = e->pl().isSecondary();
+      er.sink = e->getFrom()->pl().isSink() || e->getTo()->pl().isSink();
+      er.closed = st.closed;
+      er.softClosed = st.softClosed;
+      er.blocked = st.blocked;
+      er.resEdgs = st.resEdgs;
+      edgs.push_back(er);
+    }
+  }
+
+  // ordered by id, which is the order in which init() created them
+  std::sort(nds.begin(), nds.end(),
+            [](const CacheNd& a, const CacheNd& b) { return a.id < b.id; });
+  std::sort(edgs.begin(), edgs.end(),
+            [](const CacheEdg& a, const CacheEdg& b) { return a.id < b.id; });
+
+  CacheHeader h;
+  memcpy(h.magic, CACHE_MAGIC, sizeof(h.magic));
+  h.key = key;
+  h.numNdIds = _nds.size();
+  h.numNds = nds.size();
+  h.numEdgs = edgs.size();
+  h.edgeCount = _edgeCount;
+  h.xWidth = _grid.getXWidth();
+  h.yHeight = _grid.getYHeight();
+
+  out->write(reinterpret_cast<const char*>(&h), sizeof(h));
+  out->write(reinterpret_cast<const char*>(nds.data()),
+             nds.size() * sizeof(CacheNd));
+  out->write(reinterpret_cast<const char*>(edgs.data()),
+             edgs.size() * sizeof(CacheEdg));
+
+  return out->good();
+}
+
+// _____________________________________________________________________________
+bool GridGraph::initFromCache(std::istream* in, uint64_t key) {
+  if (!cacheable() || getNds().size()) return false;
+
+  CacheHeader h;
+  if (!in->read(reinterpret_cast<char*>(&h), sizeof(h))) return false;
+
+  if (memcmp(h.magic, CACHE_MAGIC, sizeof(h.magic)) != 0 || h.key != key ||
+      h.xWidth != _grid.getXWidth() || h.yHeight != _grid.getYHeight() ||
+      h.numNds > h.numNdIds || h.numNdIds >= CACHE_NONE) {
+    return false;
+  }
+
+  std::vector<CacheNd> nds(h.numNds);
+  std::vector<CacheEdg> edgs(h.numEdgs);
+
+  if (!in->read(reinterpret_cast<char*>(nds.data()),
+                nds.size() * sizeof(CacheNd)) ||
+      !in->read(reinterpret_cast<char*>(edgs.data()),
+                edgs.size() * sizeof(CacheEdg))) {
+    return false;
+  }
+
+  // validate before anything is built, node ids must be strictly increasing
+  std::vector<char> present(h.numNdIds, 0);
+  for (size_t i = 0; i < nds.size(); i++) {
+    if (nds[i].id >= h.numNdIds || (i && nds[i].id <= nds[i - 1].id)) {
+      return false;
+    }
+    present[nds[i].id] = 1;
+  }
+
+  auto valid = [&](uint32_t id) { return id < h.numNdIds && present[id]; };
+
+  for (const auto& r : nds) {
+    if (r.parent != CACHE_NONE && !valid(r.parent)) return false;
+    if (r.sink && (r.gridX >= h.xWidth || r.gridY >= h.yHeight)) return false;
+    for (size_t p = 0; p < maxDeg(); p++) {
+      if (r.ports[p] != CACHE_NONE && !valid(r.ports[p])) return false;
+    }
+  }
+
+  for (const auto& r : edgs) {
+    if (!valid(r.from) || !valid(r.to)) return false;
+  }
+
+  // pruned ports leave holes in the id space
+  _nds.assign(h.numNdIds, 0);
+
+  for (const auto& r : nds) {
+    GridNode* n = addNd(DPoint(r.x, r.y));
+    n->pl().setId(r.id);
+    _nds[r.id] = n;
+  }
+
+  for (const auto& r : nds) {
+    GridNode* n = _nds[r.id];
+    if (r.parent != CACHE_NONE) n->pl().setParent(_nds[r.parent]);
+    n->pl().setClosed(r.closed);
+    n->pl().setSettled(r.settled);
+
+    if (r.sink) {
+      n->pl().setSink();
+      n->pl().setXY(r.gridX, r.gridY);
+      _grid.add(r.gridX, r.gridY, n);
+      for (size_t p = 0; p < maxDeg(); p++) {
+        n->pl().setPort(p, r.ports[p] == CACHE_NONE ? 0 : _nds[r.ports[p]]);
+      }
+    }
+  }
+
+  for (const auto& r : edgs) {
+    auto e = addEdg(_nds[r.from], _nds[r.to],
+                    GridEdgePL(r.c, r.secondary, r.sink));
+    e->pl().setId(r.id);
+
+    GridEdgeState st = e->pl().getState();
+    st.closed = r.closed;
+    st.softClosed = r.softClosed;
+    st.blocked = r.blocked;
+    st.resEdgs = r.resEdgs;
+    e->pl().setState(st);
+  }
+
+  _edgeCount = h.edgeCount;
+
+  return true;
+}
+
+// _____________________________________________________________________________
+std::unordered_map<const CombNode*, GridNode*>& GridGraph::settledMap() {
+  if (GridOverlay::cur()) return GridOverlay::cur()->settled();
+  return _settled;
+}
+
+// _____________________________________________________________________________
+const std::unordered_map<const CombNode*, GridNode*>& GridGraph::settledMap()
+    const {
+  if (GridOverlay::cur()) return GridOverlay::cur()->settled();
+  return _settled;
+}
+
+// _____________________________________________________________________________
+std::unordered_map<GridEdge*, std::set<CombEdge*>>& GridGraph::resEdgsMap() {
+  if (GridOverlay::cur()) return GridOverlay::cur()->resEdgs();
+  return _resEdgs;
+}
+
+// _____________________________________________________________________________
+const std::unordered_map<GridEdge*, std::set<CombEdge*>>&
+GridGraph::resEdgsMap() const {
+  if (GridOverlay::cur()) return GridOverlay::cur()->resEdgs();
+  return _resEdgs;
+}
+
 // _____________________________________________________________________________
 void GridGraph::reWriteObstCosts() {
-  for (const auto& obst : _obstacles) writeObstacleCost(obst);
+  // the edges blocked by obstacles do not change, no need to rasterize the
+  // obstacles again
+  for (auto ge : _obstEdgs) {
+    ge->pl().setCost(std::numeric_limits<double>::infinity());
+  }
 }
 
 // _____________________________________________________________________________
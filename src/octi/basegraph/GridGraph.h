@@ -5,12 +5,15 @@
 #ifndef OCTI_BASEGRAPH_GRIDGRAPH_H_
 #define OCTI_BASEGRAPH_GRIDGRAPH_H_
 
+#include <cmath>
 #include <queue>
 #include <set>
 #include <unordered_map>
 #include "octi/basegraph/BaseGraph.h"
 #include "octi/basegraph/GridEdgePL.h"
+#include "octi/basegraph/GridLandmarks.h"
 #include "octi/basegraph/GridNodePL.h"
+#include "octi/basegraph/GridOverlay.h"
 #include "octi/basegraph/NodeCost.h"
 #include "octi/combgraph/CombGraph.h"
 #include "util/geo/Geo.h"
@@ -75,6 +78,9 @@ class GridGraph : public BaseGraph {
   virtual void init();
   virtual void reset();
 
+  virtual bool writeCache(std::ostream* out, uint64_t key) const;
+  virtual bool initFromCache(std::istream* in, uint64_t key);
+
   virtual GridNode* getSettled(const CombNode* cnd) const;
 
   virtual double ndMovePen(const CombNode* cbNd, const GridNode* grNd) const;
@@ -87,11 +93,13 @@ class GridGraph : public BaseGraph {
 
   virtual CrossEdgPairs getCrossEdgPairs() const;
 
-  virtual void writeGeoCoursePens(const CombEdge* ce, GeoPensMap* target,
-                                  double pen);
+  virtual void writeGeoCoursePens(const CombEdge* ce, GeoPensRow* target,
+                                  double pen) const;
 
   virtual void addObstacle(const util::geo::Polygon<double>& obst);
 
+  virtual void writeLandmarks(size_t num);
+
   virtual const util::graph::Dijkstra::HeurFunc<GridNodePL, GridEdgePL, float>*
   getHeur(const std::set<GridNode*>& to) const;
 
@@ -118,15 +126,41 @@ class GridGraph : public BaseGraph {
 
   std::vector<util::geo::Polygon<double>> _obstacles;
 
+  // grid edges blocked by obstacles, written once in addObstacle()
+  std::vector<GridEdge*> _obstEdgs;
+
+  // landmark distances for the ALT heuristic, empty if not used
+  GridLandmarks _landmarks;
+
+  // maximum length of an edge between two neighboring grid nodes, computed
+  // on the first obstacle
+  double _maxNEdgLen;
+
   // may be multiple resident edges if hard constraints are relaxed
   std::unordered_map<GridEdge*, std::set<CombEdge*>> _resEdgs;
 
   const Grid<GridNode*, Point, double>& getGrid() const;
 
+  // settled nodes and resident edges as seen by the current thread, these
+  // are held by the overlay bound to the thread, if any
+  std::unordered_map<const CombNode*, GridNode*>& settledMap();
+  const std::unordered_map<const CombNode*, GridNode*>& settledMap() const;
+  std::unordered_map<GridEdge*, std::set<CombEdge*>>& resEdgsMap();
+  const std::unordered_map<GridEdge*, std::set<CombEdge*>>& resEdgsMap() const;
+
+  void delResEdg(GridEdge* ge, CombEdge* ce);
+  bool hasResEdgs(const GridEdge* ge) const;
+
+  // true if all state written by init() is held by GridGraph itself, so the
+  // graph can be stored with writeCache()
+  virtual bool cacheable() const;
+
   virtual void writeInitialCosts();
   virtual void writeObstacleCost(const util::geo::Polygon<double>& obst);
   virtual void reWriteObstCosts();
 
+  double maxNEdgLen() const;
+
   virtual double getBendPen(size_t origI, size_t targetI) const;
   virtual size_t ang(size_t i, size_t j) const;
 
@@ -211,6 +245,55 @@ struct GridGraphHeur
   float cheapestSink;
 };
 
+// GridGraphHeur, tightened by the landmark bounds of GridLandmarks. Per
+// landmark l, the minimum distance from l to any port of a target cell is
+// computed once, so a node expansion only costs a max over the landmarks.
+struct GridLandmarkHeur : public GridGraphHeur {
+  GridLandmarkHeur(const basegraph::GridGraph* g, const GridLandmarks* lms,
+                   const std::set<GridNode*>& to)
+      : GridGraphHeur(g, to), lms(lms) {
+    minTo.resize(lms->size(), std::numeric_limits<double>::infinity());
+
+    for (auto n : to) {
+      for (size_t i = 0; i < g->maxDeg(); i++) {
+        auto port = n->pl().getPort(i);
+        if (!port) continue;
+        for (size_t l = 0; l < lms->size(); l++) {
+          minTo[l] = std::min(minTo[l], lms->dist(l, port));
+        }
+      }
+    }
+  }
+
+  float operator()(const GridNode* from, const std::set<GridNode*>& to) const {
+    if (to.count(from->pl().getParent())) return 0;
+
+    double ret = 0;
+
+    for (size_t l = 0; l < minTo.size(); l++) {
+      double d = lms->dist(l, from);
+
+      // landmarks not connected to both sides give no bound
+      if (d == std::numeric_limits<double>::infinity() ||
+          minTo[l] == std::numeric_limits<double>::infinity()) {
+        continue;
+      }
+      if (minTo[l] - d > ret) ret = minTo[l] - d;
+    }
+
+    ret += cheapestSink;
+
+    // narrowing may round up, which would overestimate the distance
+    float lb = ret;
+    if (lb > ret) lb = std::nextafter(lb, 0.0f);
+
+    return std::max(lb, GridGraphHeur::operator()(from, to));
+  }
+
+  const GridLandmarks* lms;
+  std::vector<double> minTo;
+};
+
 }  // namespace basegraph
 }  // namespace octi
 
@@ -0,0 +1,100 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include "octi/basegraph/GridLandmarks.h"
+
+using octi::basegraph::GridLandmarks;
+using octi::basegraph::GridNode;
+
+// _____________________________________________________________________________
+GridLandmarks::GridLandmarks(const BaseGraph* g, size_t num) : _numNds(0) {
+  for (auto n : g->getNds()) {
+    if (n->pl().getId() + 1 > _numNds) _numNds = n->pl().getId() + 1;
+  }
+
+  std::vector<const GridNode*> nds(_numNds, 0);
+  for (auto n : g->getNds()) nds[n->pl().getId()] = n;
+
+  const GridNode* start = 0;
+  for (auto n : nds) {
+    if (n && !n->pl().isSink()) {
+      start = n;
+      break;
+    }
+  }
+
+  if (!start || num == 0) return;
+
+  double inf = std::numeric_limits<double>::infinity();
+
+  // minimum distance of each node to the landmarks selected so far, the
+  // first landmark is the node farthest from an arbitrary start node
+  std::vector<double> minDist(_numNds, inf);
+  dijkstra(nds, start, minDist.data());
+
+  _dists.resize(num * _numNds);
+
+  for (size_t l = 0; l < num; l++) {
+    const GridNode* next = 0;
+    double maxD = 0;
+    for (size_t i = 0; i < _numNds; i++) {
+      if (!nds[i] || nds[i]->pl().isSink() || minDist[i] == inf) continue;
+      if (minDist[i] > maxD) {
+        maxD = minDist[i];
+        next = nds[i];
+      }
+    }
+
+    // all remaining nodes coincide with a landmark
+    if (!next) break;
+
+    _lms.push_back(next);
+    double* d = _dists.data() + l * _numNds;
+    dijkstra(nds, next, d);
+
+    for (size_t i = 0; i < _numNds; i++) {
+      if (l == 0 || d[i] < minDist[i]) minDist[i] = d[i];
+    }
+  }
+
+  _dists.resize(_lms.size() * _numNds);
+}
+
+// _____________________________________________________________________________
+void GridLandmarks::dijkstra(const std::vector<const GridNode*>& nds,
+                             const GridNode* from, double* dists) const {
+  typedef std::pair<double, size_t> PQEntry;
+
+  double* d = dists;
+  std::fill(d, d + _numNds, std::numeric_limits<double>::infinity());
+  std::vector<bool> settled(_numNds, false);
+  std::priority_queue<PQEntry, std::vector<PQEntry>, std::greater<PQEntry>> pq;
+
+  d[from->pl().getId()] = 0;
+  pq.push({0, from->pl().getId()});
+
+  while (!pq.empty()) {
+    auto cur = pq.top();
+    pq.pop();
+
+    if (settled[cur.second]) continue;
+    settled[cur.second] = true;
+
+    for (auto e : nds[cur.second]->getAdjListOut()) {
+      double c = e->pl().cost();
+      if (c == INF) continue;
+
+      size_t to = e->getTo()->pl().getId();
+      if (settled[to] || cur.first + c >= d[to]) continue;
+
+      d[to] = cur.first + c;
+      pq.push({d[to], to});
+    }
+  }
+}
@@ -0,0 +1,55 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef OCTI_BASEGRAPH_GRIDLANDMARKS_H_
+#define OCTI_BASEGRAPH_GRIDLANDMARKS_H_
+
+#include <limits>
+#include <vector>
+#include "octi/basegraph/BaseGraph.h"
+
+namespace octi {
+namespace basegraph {
+
+// Shortest path distances from a small set of landmark grid nodes, used for
+// ALT (A*, landmarks, triangle inequality) lower bounds. Distances are taken
+// under the edge costs of the graph at construction time, which must be the
+// static costs written by init() and addObstacle(). Routing only ever raises
+// the costs of non-sink edges above these, so for any nodes u, v and any
+// landmark l
+//
+//   d(u, v) >= dist(l, v) - dist(l, u).
+//
+// Sink edges are closed at construction time and thus never part of a
+// landmark path. Landmarks are picked by farthest point selection. Distances
+// are kept as doubles, a bound narrowed to float must be rounded down.
+class GridLandmarks {
+ public:
+  GridLandmarks() : _numNds(0) {}
+  GridLandmarks(const BaseGraph* g, size_t num);
+
+  size_t size() const { return _lms.size(); }
+
+  // distance from landmark l to n, infinity if n cannot be reached
+  double dist(size_t l, const GridNode* n) const {
+    size_t id = n->pl().getId();
+    if (id >= _numNds) return std::numeric_limits<double>::infinity();
+    return _dists[l * _numNds + id];
+  }
+
+  // bytes held by the distance table
+  size_t memUsage() const { return _dists.size() * sizeof(double); }
+
+ private:
+  size_t _numNds;
+  std::vector<const GridNode*> _lms;
+  std::vector<double> _dists;
+
+  void dijkstra(const std::vector<const GridNode*>& nds, const GridNode* from,
+                double* dists) const;
+};
+}  // namespace basegraph
+}  // namespace octi
+
+#endif  // OCTI_BASEGRAPH_GRIDLANDMARKS_H_
@@ -9,7 +9,24 @@ using namespace octi::basegraph;
 
 // _____________________________________________________________________________
 GridNodePL::GridNodePL(Point<double> pos)
-    : _pos(pos), _parent(0), _closed(false), _sink(false), _settled(false) {}
+    : _pos(pos), _parent(0), _sink(false) {
+  _st.closed = false;
+  _st.settled = false;
+}
+
+// _____________________________________________________________________________
+const GridNodeState& GridNodePL::st() const {
+  auto o = GridOverlay::cur();
+  if (o) return o->nd(_id, _st);
+  return _st;
+}
+
+// _____________________________________________________________________________
+GridNodeState& GridNodePL::mutSt() {
+  auto o = GridOverlay::cur();
+  if (o) return o->mutNd(_id, _st);
+  return _st;
+}
 
 // _____________________________________________________________________________
 const Point<double>* GridNodePL::getGeom() const { return &_pos; }
@@ -18,8 +35,8 @@ const Point<double>* GridNodePL::getGeom() const { return &_pos; }
 util::json::Dict GridNodePL::getAttrs() const {
   util::json::Dict obj;
 
-  obj["settled"] = _settled ? "1" : "0";
-  obj["closed"] = _closed ? "1" : "0";
+  obj["settled"] = st().settled ? "1" : "0";
+  obj["closed"] = st().closed ? "1" : "0";
   obj["grid"] = util::toString(_id);
   obj["x"] = util::toString(_x);
   obj["y"] = util::toString(_y);
@@ -58,16 +75,16 @@ size_t GridNodePL::getX() const { return _parent->pl()._x; }
 size_t GridNodePL::getY() const { return _parent->pl()._y; }
 
 // _____________________________________________________________________________
-void GridNodePL::setClosed(bool c) { _closed = c; }
+void GridNodePL::setClosed(bool c) { mutSt().closed = c; }
 
 // _____________________________________________________________________________
-bool GridNodePL::isClosed() const { return _closed; }
+bool GridNodePL::isClosed() const { return st().closed; }
 
 // _____________________________________________________________________________
-void GridNodePL::setSettled(bool c) { _settled = c; }
+void GridNodePL::setSettled(bool c) { mutSt().settled = c; }
 
 // _____________________________________________________________________________
-bool GridNodePL::isSettled() const { return _settled; }
+bool GridNodePL::isSettled() const { return st().settled; }
 
 // _____________________________________________________________________________
 void GridNodePL::setSink() { _sink = true; }
@@ -6,6 +6,7 @@
 #define OCTI_BASEGRAPH_GRIDNODEPL_H_
 
 #include "octi/basegraph/GridEdgePL.h"
+#include "octi/basegraph/GridOverlay.h"
 #include "util/geo/Geo.h"
 #include "util/geo/GeoGraph.h"
 #include "util/graph/Node.h"
@@ -51,6 +52,10 @@ class GridNodePL : util::geograph::GeoNodePL<double> {
   size_t getId() const;
 
  private:
+  // state as seen by the current thread, see GridOverlay
+  const GridNodeState& st() const;
+  GridNodeState& mutSt();
+
   Point<double> _pos;
 
   GridNode* _parent;
@@ -58,9 +63,8 @@ class GridNodePL : util::geograph::GeoNodePL<double> {
 
   uint32_t _x, _y;
   uint32_t _id;
-  bool _closed : 1;
+  GridNodeState _st;
   bool _sink : 1;
-  bool _settled : 1;
 };
 }  // namespace basegraph
 }  // namespace octi
@@ -0,0 +1,93 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include "octi/basegraph/GridOverlay.h"
+
+using octi::basegraph::GridEdge;
+using octi::basegraph::GridEdgeState;
+using octi::basegraph::GridNode;
+using octi::basegraph::GridNodeState;
+using octi::basegraph::GridOverlay;
+
+thread_local GridOverlay* GridOverlay::_cur = 0;
+
+// _____________________________________________________________________________
+GridOverlay* GridOverlay::bind(GridOverlay* o) {
+  GridOverlay* prev = _cur;
+  _cur = o;
+  return prev;
+}
+
+// _____________________________________________________________________________
+const GridEdgeState& GridOverlay::edg(size_t id,
+                                      const GridEdgeState& base) const {
+  // the dirty bit saves the hash lookup for the (vast majority of) untouched
+  // edges
+  if (id >= _edgDirty.size() || !_edgDirty[id]) return base;
+  return _edgs.find(id)->second;
+}
+
+// _____________________________________________________________________________
+GridEdgeState& GridOverlay::mutEdg(size_t id, const GridEdgeState& base) {
+  if (id >= _edgDirty.size()) _edgDirty.resize(id + 1 + id / 2, false);
+  if (!_edgDirty[id]) {
+    _edgDirty[id] = true;
+    return _edgs.insert({id, base}).first->second;
+  }
+  return _edgs.find(id)->second;
+}
+
+// _____________________________________________________________________________
+const GridNodeState& GridOverlay::nd(size_t id,
+                                     const GridNodeState& base) const {
+  if (id >= _ndDirty.size() || !_ndDirty[id]) return base;
+  return _nds.find(id)->second;
+}
+
+// _____________________________________________________________________________
+GridNodeState& GridOverlay::mutNd(size_t id, const GridNodeState& base) {
+  if (id >= _ndDirty.size()) _ndDirty.resize(id + 1 + id / 2, false);
+  if (!_ndDirty[id]) {
+    _ndDirty[id] = true;
+    return _nds.insert({id, base}).first->second;
+  }
+  return _nds.find(id)->second;
+}
+
+// _____________________________________________________________________________
+std::unordered_map<const CombNode*, GridNode*>& GridOverlay::settled() {
+  return _settled;
+}
+
+// _____________________________________________________________________________
+const std::unordered_map<const CombNode*, GridNode*>& GridOverlay::settled()
+    const {
+  return _settled;
+}
+
+// _____________________________________________________________________________
+std::unordered_map<GridEdge*, std::set<CombEdge*>>& GridOverlay::resEdgs() {
+  return _resEdgs;
+}
+
+// _____________________________________________________________________________
+const std::unordered_map<GridEdge*, std::set<CombEdge*>>&
+GridOverlay::resEdgs() const {
+  return _resEdgs;
+}
+
+// _____________________________________________________________________________
+void GridOverlay::clear() {
+  // only reset the dirty bits we have actually set
+  for (const auto& e : _edgs) _edgDirty[e.first] = false;
+  for (const auto& n : _nds) _ndDirty[n.first] = false;
+
+  _edgs.clear();
+  _nds.clear();
+  _settled.clear();
+  _resEdgs.clear();
+}
+
+// _____________________________________________________________________________
+size_t GridOverlay::size() const { return _edgs.size() + _nds.size(); }
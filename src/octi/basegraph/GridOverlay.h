@@ -0,0 +1,107 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef OCTI_BASEGRAPH_GRIDOVERLAY_H_
+#define OCTI_BASEGRAPH_GRIDOVERLAY_H_
+
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include "octi/combgraph/CombGraph.h"
+#include "util/graph/Node.h"
+
+using octi::combgraph::CombEdge;
+using octi::combgraph::CombNode;
+
+namespace octi {
+namespace basegraph {
+
+class GridNodePL;
+class GridEdgePL;
+typedef util::graph::Node<GridNodePL, GridEdgePL> GridNode;
+typedef util::graph::Edge<GridNodePL, GridEdgePL> GridEdge;
+
+// the mutable part of a grid edge payload
+struct GridEdgeState {
+  float c;
+
+  bool closed : 1;
+  bool softClosed : 1;
+
+  // edges are blocked if they would cross a settled edge
+  bool blocked : 1;
+
+  uint8_t resEdgs : 8;
+};
+
+// the mutable part of a grid node payload
+struct GridNodeState {
+  bool closed : 1;
+  bool settled : 1;
+};
+
+// Sparse copy-on-write layer on top of a shared base graph. While an overlay
+// is bound to the current thread, all reads of node and edge states are
+// redirected to the overlay copy (if present), and all writes are applied to
+// a copy held by the overlay, leaving the base graph untouched. This allows
+// several threads to draw on the same base graph at the same time, each
+// thread only paying memory for the nodes and edges it has actually modified.
+// An overlay must only ever be used with a single base graph.
+class GridOverlay {
+ public:
+  GridOverlay() {}
+
+  const GridEdgeState& edg(size_t id, const GridEdgeState& base) const;
+  GridEdgeState& mutEdg(size_t id, const GridEdgeState& base);
+
+  const GridNodeState& nd(size_t id, const GridNodeState& base) const;
+  GridNodeState& mutNd(size_t id, const GridNodeState& base);
+
+  // settled comb nodes and resident edges as seen by this overlay
+  std::unordered_map<const CombNode*, GridNode*>& settled();
+  const std::unordered_map<const CombNode*, GridNode*>& settled() const;
+
+  std::unordered_map<GridEdge*, std::set<CombEdge*>>& resEdgs();
+  const std::unordered_map<GridEdge*, std::set<CombEdge*>>& resEdgs() const;
+
+  // drop all modifications, the overlay then equals the base graph again
+  void clear();
+
+  // number of node and edge states held by the overlay
+  size_t size() const;
+
+  // the overlay bound to the calling thread, or 0
+  static GridOverlay* cur() { return _cur; }
+
+  // bind overlay o to the calling thread (0 to unbind), returns the
+  // previously bound overlay
+  static GridOverlay* bind(GridOverlay* o);
+
+ private:
+  std::vector<bool> _edgDirty, _ndDirty;
+  std::unordered_map<uint32_t, GridEdgeState> _edgs;
+  std::unordered_map<uint32_t, GridNodeState> _nds;
+
+  std::unordered_map<const CombNode*, GridNode*> _settled;
+  std::unordered_map<GridEdge*, std::set<CombEdge*>> _resEdgs;
+
+  static thread_local GridOverlay* _cur;
+};
+
+// binds an overlay to the calling thread for the lifetime of the scope
+class GridOverlayScope {
+ public:
+  explicit GridOverlayScope(GridOverlay* o) : _prev(GridOverlay::bind(o)) {}
+  ~GridOverlayScope() { GridOverlay::bind(_prev); }
+
+  GridOverlayScope(const GridOverlayScope&) = delete;
+  GridOverlayScope& operator=(const GridOverlayScope&) = delete;
+
+ private:
+  GridOverlay* _prev;
+};
+}  // namespace basegraph
+}  // namespace octi
+
+#endif  // OCTI_BASEGRAPH_GRIDOVERLAY_H_
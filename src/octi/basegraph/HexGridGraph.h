@@ -31,10 +31,16 @@ class HexGridGraph : public GridGraph {
   virtual GridEdge* getNEdg(const GridNode* a, const GridNode* b) const;
   virtual const util::graph::Dijkstra::HeurFunc<GridNodePL, GridEdgePL, float>*
   getHeur(const std::set<GridNode*>& to) const;
+
+  // the own heuristic does not use landmarks
+  virtual void writeLandmarks(size_t) {}
   virtual size_t maxDeg() const;
   virtual std::vector<double> getCosts() const;
 
  protected:
+  // built by init() only, see GridGraph::writeCache()
+  virtual bool cacheable() const { return false; }
+
   virtual void writeInitialCosts();
   virtual double getBendPen(size_t i, size_t j) const;
   virtual GridNode* writeNd(size_t x, size_t y);
@@ -46,17 +46,17 @@ void OctiGridGraph::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
   ge->pl().delResEdg();
   gf->pl().delResEdg();
 
-  _resEdgs[ge].erase(ce);
-  _resEdgs[gf].erase(ce);
+  delResEdg(ge, ce);
+  delResEdg(gf, ce);
 
-  if (_resEdgs[ge].size() == 0) {
+  if (!hasResEdgs(ge)) {
     if (!a->pl().isSettled()) openTurns(a);
     if (!b->pl().isSettled()) openTurns(b);
   }
 
   // unblock blocked diagonal edges crossing this edge
   size_t dir = getDir(a, b);
-  if (dir % 2 != 0 && _resEdgs[ge].size() == 0) {
+  if (dir % 2 != 0 && !hasResEdgs(ge)) {
     size_t x = a->pl().getX();
     size_t y = a->pl().getY();
 
@@ -41,16 +41,16 @@ void OctiHananGraph::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
   ge->pl().delResEdg();
   gf->pl().delResEdg();
 
-  _resEdgs[ge].erase(ce);
-  _resEdgs[gf].erase(ce);
+  delResEdg(ge, ce);
+  delResEdg(gf, ce);
 
-  if (_resEdgs[ge].size() == 0) {
+  if (!hasResEdgs(ge)) {
     if (!a->pl().isSettled() && unused(a)) openTurns(a);
     if (!b->pl().isSettled() && unused(b)) openTurns(b);
   }
 
   // unblock blocked diagonal edges crossing this edge
-  if (getDir(a, b) % 2 != 0 && _resEdgs[ge].size() == 0) {
+  if (getDir(a, b) % 2 != 0 && !hasResEdgs(ge)) {
     auto pairs = _edgePairs.find(ge);
     if (pairs == _edgePairs.end()) return;
     for (auto p : pairs->second) {
@@ -27,6 +27,9 @@ class OctiHananGraph : public OctiGridGraph {
   virtual void init();
 
  protected:
+  // built by init() only, see GridGraph::writeCache()
+  virtual bool cacheable() const { return false; }
+
   virtual GridNode* writeNd(size_t x, size_t y);
   virtual GridNode* neigh(size_t cx, size_t cy, size_t i) const;
   virtual GridNode* getNode(size_t x, size_t y) const;
@@ -36,10 +36,10 @@ void OctiQuadTree::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
   ge->pl().delResEdg();
   gf->pl().delResEdg();
 
-  _resEdgs[ge].erase(ce);
-  _resEdgs[gf].erase(ce);
+  delResEdg(ge, ce);
+  delResEdg(gf, ce);
 
-  if (_resEdgs[ge].size() == 0) {
+  if (!hasResEdgs(ge)) {
     if (!a->pl().isSettled() && unused(a)) openTurns(a);
     if (!b->pl().isSettled() && unused(b)) openTurns(b);
   }
@@ -68,7 +68,7 @@ void OctiQuadTree::unSettleEdg(CombEdge* ce, GridNode* a, GridNode* b) {
     bb = getNode(a->pl().getX(), a->pl().getY() + len);
   }
 
-  if (aa && bb && _resEdgs[ge].size() == 0) {
+  if (aa && bb && !hasResEdgs(ge)) {
     auto e = getNEdg(aa, bb);
     auto f = getNEdg(bb, aa);
     if (e && f) {
@@ -49,6 +49,7 @@ void PseudoOrthoRadialGraph::writeObstacleCost(
                                                *ge->getTo()->pl().getGeom()),
                 obst)) {
           ge->pl().setCost(std::numeric_limits<double>::infinity());
+          _obstEdgs.push_back(ge);
         }
       }
     }
@@ -57,8 +58,8 @@ void PseudoOrthoRadialGraph::writeObstacleCost(
 
 // _____________________________________________________________________________
 void PseudoOrthoRadialGraph::writeGeoCoursePens(const CombEdge* ce,
-                                                GeoPensMap* target,
-                                                double pen) {
+                                                GeoPensRow* target,
+                                                double pen) const {
   std::set<GridNode*> neighs;
 
   DBox box;
@@ -97,7 +98,7 @@ void PseudoOrthoRadialGraph::writeGeoCoursePens(const CombEdge* ce,
 
       d *= pen * d;
 
-      if (d <= SOFT_INF) (*target)[ce][ge->pl().getId()] = d;
+      if (d <= SOFT_INF) target->push_back({ge->pl().getId(), d});
     }
   }
 }
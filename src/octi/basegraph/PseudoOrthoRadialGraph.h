@@ -27,15 +27,21 @@ class PseudoOrthoRadialGraph : public GridGraph {
   virtual GridEdge* getNEdg(const GridNode* a, const GridNode* b) const;
   virtual const util::graph::Dijkstra::HeurFunc<GridNodePL, GridEdgePL, float>*
   getHeur(const std::set<GridNode*>& to) const;
+
+  // the own heuristic does not use landmarks
+  virtual void writeLandmarks(size_t) {}
   virtual double heurCost(int64_t xa, int64_t ya, int64_t xb, int64_t yb) const;
 
   virtual PolyLine<double> geomFromPath(
       const std::vector<std::pair<size_t, size_t>>& res) const;
   virtual double ndMovePen(const CombNode* cbNd, const GridNode* grNd) const;
-  virtual void writeGeoCoursePens(const CombEdge* ce, GeoPensMap* target,
-                                  double pen);
+  virtual void writeGeoCoursePens(const CombEdge* ce, GeoPensRow* target,
+                                  double pen) const;
 
  protected:
+  // built by init() only, see GridGraph::writeCache()
+  virtual bool cacheable() const { return false; }
+
   virtual void writeInitialCosts();
   virtual GridNode* writeNd(size_t x, size_t y);
   virtual GridNode* neigh(size_t cx, size_t cy, size_t i) const;
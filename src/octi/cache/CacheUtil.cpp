@@ -0,0 +1,34 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include "octi/cache/CacheUtil.h"
+
+// _____________________________________________________________________________
+bool octi::cache::writeAtomic(
+    const std::string& path,
+    const std::function<bool(std::ostream*)>& write) {
+  // unique per process and thread
+  std::stringstream tmp;
+  tmp << path << ".tmp." << getpid() << "."
+      << std::hash<std::thread::id>()(std::this_thread::get_id());
+
+  std::ofstream out(tmp.str(), std::ios::binary);
+  if (!out.good()) return false;
+
+  bool ok = write(&out);
+  out.close();
+
+  if (!ok || !out.good() ||
+      std::rename(tmp.str().c_str(), path.c_str()) != 0) {
+    std::remove(tmp.str().c_str());
+    return false;
+  }
+
+  return true;
+}
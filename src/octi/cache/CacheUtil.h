@@ -0,0 +1,69 @@
+// Copyright 2017, University of Freiburg,
+// Chair of Algorithms and Data Structures.
+// Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
+
+#ifndef OCTI_CACHE_CACHEUTIL_H_
+#define OCTI_CACHE_CACHEUTIL_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "util/geo/Geo.h"
+
+namespace octi {
+namespace cache {
+
+// FNV-1a hash, used as the key of on-disk caches
+class Fingerprint {
+ public:
+  void add(const void* data, size_t n) {
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < n; i++) {
+      _h ^= b[i];
+      _h *= 1099511628211ull;
+    }
+  }
+
+  void add(int64_t v) { add(&v, sizeof(v)); }
+  void add(double v) { add(&v, sizeof(v)); }
+
+  // length prefixed, to keep consecutive strings apart
+  void add(const std::string& str) {
+    add(static_cast<int64_t>(str.size()));
+    add(str.data(), str.size());
+  }
+
+  // rounded to centimeters
+  void add(const util::geo::DPoint& p) {
+    add(static_cast<int64_t>(std::llround(p.getX() * 100)));
+    add(static_cast<int64_t>(std::llround(p.getY() * 100)));
+  }
+
+  // order independent
+  void add(std::vector<uint64_t>* hashes) {
+    std::sort(hashes->begin(), hashes->end());
+    add(static_cast<int64_t>(hashes->size()));
+    add(hashes->data(), hashes->size() * sizeof(uint64_t));
+  }
+
+  uint64_t get() const { return _h; }
+
+ private:
+  uint64_t _h = 14695981039346656037ull;
+};
+
+// Write a cache file at path with write(). The file is written to a
+// temporary file first and then renamed, so concurrent readers never see a
+// partial file. Returns false (and leaves no file behind) if write() or the
+// output failed.
+bool writeAtomic(const std::string& path,
+                 const std::function<bool(std::ostream*)>& write);
+
+}  // namespace cache
+}  // namespace octi
+
+#endif  // OCTI_CACHE_CACHEUTIL_H_
@@ -30,10 +30,15 @@ class CombEdgePL : util::geograph::GeoEdgePL<double> {
   size_t getNumLines() const { return _maxLineNum; }
   void setNumLines(size_t numLines) { _maxLineNum = numLines; }
 
+  // dense id of this edge in the comb graph
+  void setId(size_t id) { _id = id; }
+  size_t getId() const { return _id; }
+
  private:
   std::vector<shared::linegraph::LineEdge*> _childs;
 
   size_t _maxLineNum;
+  size_t _id;
 
   PolyLine<double> _geom;
 };
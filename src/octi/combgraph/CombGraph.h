@@ -29,12 +29,18 @@ class CombGraph : public util::graph::UndirGraph<CombNodePL, CombEdgePL> {
 
   const util::geo::DBox& getBBox() const;
 
+  // number of distinct node and edge ids, ids are in [0, num)
+  size_t numNdIds() const;
+  size_t numEdgIds() const;
+
  private:
   util::geo::Box<double> _bbox;
+  size_t _numNdIds, _numEdgIds;
   void build(const LineGraph* source);
   void combineDeg2();
   void writeEdgeOrdering();
   void writeMaxLineNum();
+  void writeIds();
 };
 
 }  // namespace combgraph
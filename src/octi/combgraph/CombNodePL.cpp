@@ -9,7 +9,7 @@ using octi::combgraph::CombNodePL;
 
 // _____________________________________________________________________________
 CombNodePL::CombNodePL(shared::linegraph::LineNode* parent)
-    : _parent(parent) {}
+    : _parent(parent), _id(0) {}
 
 // _____________________________________________________________________________
 const Point<double>* CombNodePL::getGeom() const {
@@ -32,6 +32,12 @@ void CombNodePL::setRouteNumber(size_t n) { _routeNumber = n; }
 // _____________________________________________________________________________
 size_t CombNodePL::getLDeg() const { return _routeNumber; }
 
+// _____________________________________________________________________________
+void CombNodePL::setId(size_t id) { _id = id; }
+
+// _____________________________________________________________________________
+size_t CombNodePL::getId() const { return _id; }
+
 // _____________________________________________________________________________
 const octi::combgraph::EdgeOrdering& CombNodePL::getEdgeOrdering() {
   return _ordering;
@@ -32,9 +32,14 @@ class CombNodePL : util::geograph::GeoNodePL<double> {
   void setRouteNumber(size_t n);
   std::string toString() const;
 
+  // dense id of this node in the comb graph
+  void setId(size_t id);
+  size_t getId() const;
+
  private:
   shared::linegraph::LineNode* _parent;
   size_t _routeNumber;
+  size_t _id;
   combgraph::EdgeOrdering _ordering;
 };
 }
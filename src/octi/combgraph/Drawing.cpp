@@ -16,7 +16,9 @@ using octi::combgraph::CombEdge;
 using octi::combgraph::CombGraph;
 using octi::combgraph::CombNode;
 using octi::combgraph::Drawing;
+using octi::combgraph::EdgDrawing;
 using octi::combgraph::GrPath;
+using octi::combgraph::NdDrawing;
 using octi::combgraph::Score;
 using shared::linegraph::LineEdge;
 using shared::linegraph::LineGraph;
@@ -44,10 +46,10 @@ void Drawing::setBaseGraph(const BaseGraph* gg) { _gg = gg; }
 Score Drawing::fullScore() const {
   Score ret{0, 0, 0, 0, 0, 0, 0};
 
-  for (auto c : _ndReachCosts) ret.move += c.second;
-  for (auto c : _ndBndCosts) ret.bend += c.second;
-  for (auto c : _edgCosts) ret.hop += c.second;
-  for (auto c : _springCosts) ret.dense += c.second;
+  ret.move = _move;
+  ret.bend = _bend;
+  ret.hop = _hop;
+  ret.dense = _dense;
   ret.full = _c + basegraph::SOFT_INF * violations();
   ret.violations = violations();
 
@@ -56,23 +58,37 @@ Score Drawing::fullScore() const {
 
 // _____________________________________________________________________________
 void Drawing::draw(CombEdge* ce, const GrEdgList& ges, bool rev) {
+  logEdg(ce);
+  logNd(ce->getFrom());
+  logNd(ce->getTo());
+
   if (_c == std::numeric_limits<double>::infinity()) _c = 0;
-  if (_edgs.count(ce)) _edgs[ce].clear();
 
-  int l = 0;
+  // make sure both node entries exist before taking references into _nds
+  ndSt(ce->getFrom());
+  ndSt(ce->getTo());
+  NdDrawing& frNd = _nds[ce->getFrom()->pl().getId()];
+  NdDrawing& toNd = _nds[ce->getTo()->pl().getId()];
+  EdgDrawing& edg = edgSt(ce);
 
-  for (size_t i = 0; i < ges.size(); i++) {
-    auto ge = ges[i];
+  if (edg.edg) edg.path.clear();
 
+  int l = 0;
+
+  if (ges.size()) {
+    frNd.nd = ce->getFrom();
+    toNd.nd = ce->getTo();
     if (rev) {
-      _nds[ce->getFrom()] =
-          ges.front()->getTo()->pl().getParent()->pl().getId();
-      _nds[ce->getTo()] = ges.back()->getFrom()->pl().getParent()->pl().getId();
+      frNd.grNd = ges.front()->getTo()->pl().getParent()->pl().getId();
+      toNd.grNd = ges.back()->getFrom()->pl().getParent()->pl().getId();
     } else {
-      _nds[ce->getTo()] = ges.front()->getTo()->pl().getParent()->pl().getId();
-      _nds[ce->getFrom()] =
-          ges.back()->getFrom()->pl().getParent()->pl().getId();
+      toNd.grNd = ges.front()->getTo()->pl().getParent()->pl().getId();
+      frNd.grNd = ges.back()->getFrom()->pl().getParent()->pl().getId();
     }
+  }
+
+  for (size_t i = 0; i < ges.size(); i++) {
+    auto ge = ges[i];
 
     // there are three kinds of cost contained in a result:
     //  a) node reach costs, which model the cost it takes to move a node
@@ -91,33 +107,28 @@ void Drawing::draw(CombEdge* ce, const GrEdgList& ges, bool rev) {
     if (edgeCost >= basegraph::SOFT_INF) {
       int vios = edgeCost / basegraph::SOFT_INF;
       edgeCost -= vios * basegraph::SOFT_INF;
-      _vios[ce]++;
+      edg.vios++;
       _violations++;
     }
 
     _c += edgeCost;
 
-    if (i == 0) {
-      if (!_ndReachCosts.count(rev ? ce->getFrom() : ce->getTo())) {
-        // if the node was not settled before, this is the node move cost
-        _ndReachCosts[rev ? ce->getFrom() : ce->getTo()] = edgeCost;
-        _ndBndCosts[rev ? ce->getFrom() : ce->getTo()] = 0;
-      } else {
-        // otherwise it is the reach cost belonging to the edge
-        _ndBndCosts[rev ? ce->getFrom() : ce->getTo()] += edgeCost;
-      }
-    } else if (i == ges.size() - 1) {
-      if (!_ndReachCosts.count(rev ? ce->getTo() : ce->getFrom())) {
+    if (i == 0 || i == ges.size() - 1) {
+      NdDrawing& nd = ((i == 0) == rev) ? frNd : toNd;
+      if (!nd.hasReachCost) {
         // if the node was not settled before, this is the node move cost
-        _ndReachCosts[rev ? ce->getTo() : ce->getFrom()] = edgeCost;
-        _ndBndCosts[rev ? ce->getTo() : ce->getFrom()] = 0;
+        nd.hasReachCost = true;
+        nd.reachCost = edgeCost;
+        _move += edgeCost;
+        setBndCost(&nd, 0);
       } else {
         // otherwise it is the reach cost belonging to the edge
-        _ndBndCosts[rev ? ce->getTo() : ce->getFrom()] += edgeCost;
+        setBndCost(&nd, nd.bndCost + edgeCost);
       }
     } else {
       if (!ge->pl().isSecondary()) l++;
-      _edgCosts[ce] += edgeCost;
+      edg.cost += edgeCost;
+      _hop += edgeCost;
     }
 
     if (rev) {
@@ -125,12 +136,14 @@ void Drawing::draw(CombEdge* ce, const GrEdgList& ges, bool rev) {
                            ges[ges.size() - 1 - i]->getFrom());
 
       if (!e->pl().isSecondary()) {
-        _edgs[ce].push_back(
+        edg.edg = ce;
+        edg.path.push_back(
             {e->getFrom()->pl().getId(), e->getTo()->pl().getId()});
       }
     } else {
       if (!ges[i]->pl().isSecondary()) {
-        _edgs[ce].push_back(
+        edg.edg = ce;
+        edg.path.push_back(
             {ges[i]->getFrom()->pl().getId(), ges[i]->getTo()->pl().getId()});
 
         assert(_gg->getEdg(ges[i]->getFrom(), ges[i]->getTo()) == ges[i]);
@@ -159,13 +172,16 @@ void Drawing::draw(CombEdge* ce, const GrEdgList& ges, bool rev) {
   double pen = 0;
   if (F > 0) pen = E;
 
-  _springCosts[ce] = pen;
-  _c += _springCosts[ce];
+  _dense += pen - edg.springCost;
+  edg.springCost = pen;
+  _c += pen;
 }
 
 // _____________________________________________________________________________
-const GridNode* Drawing::getGrNd(const CombNode* cn) {
-  return _gg->getGrNdById(_nds[cn]);
+const GridNode* Drawing::getGrNd(const CombNode* cn) const {
+  auto nd = findNd(cn);
+  if (!nd || !nd->nd) return 0;
+  return _gg->getGrNdById(nd->grNd);
 }
 
 // _____________________________________________________________________________
@@ -186,20 +202,21 @@ void Drawing::getLineGraph(LineGraph* target) const {
 
   // settle grid nodes, _nds contains a mapping of input comb edges to
   // grid node ids
-  for (auto ndpair : _nds) {
-    auto combNd = ndpair.first;
+  for (const auto& st : _nds) {
+    if (!st.nd) continue;
+    auto combNd = st.nd;
     for (auto f : combNd->getAdjListOut()) {
       // go over each adjacent edge's image path and add nodes to the target
       // graph for the image's end and start node
 
       if (f->getFrom() != combNd) continue;
-      if (_edgs.find(f) == _edgs.end()) {
+      if (!drawn(f)) {
         LOGTO(WARN, std::cerr) << "Edge " << f << " was not drawn, skipping...";
         continue;
       }
 
       // the image path...
-      auto pth = _edgs.find(f)->second;
+      const auto& pth = findEdg(f)->path;
       assert(_gg->getGrEdgById(pth.back()));
       assert(_gg->getGrEdgById(pth.front()));
       // ... and it's from and to grid nodes. We can be sure that that
@@ -230,13 +247,14 @@ void Drawing::getLineGraph(LineGraph* target) const {
   }
 
   // build segments per path
-  for (auto ndpair : _nds) {
-    auto n = ndpair.first;
+  for (const auto& st : _nds) {
+    if (!st.nd) continue;
+    auto n = st.nd;
     for (auto f : n->getAdjListOut()) {
       if (f->getFrom() != n) continue;
-      if (_edgs.find(f) == _edgs.end()) continue;  // edge was not drawn
+      if (!drawn(f)) continue;  // edge was not drawn
 
-      auto path = _edgs.find(f)->second;
+      const auto& path = findEdg(f)->path;
 
       std::set<CombEdge*> curResEdgs;
 
@@ -301,11 +319,12 @@ void Drawing::getLineGraph(LineGraph* target) const {
   for (auto& segment : pathSegs) segment.geom = _gg->geomFromPath(segment.path);
 
   // add nodes to segments
-  for (auto ndpair : _nds) {
-    auto n = ndpair.first;
+  for (const auto& st : _nds) {
+    if (!st.nd) continue;
+    auto n = st.nd;
     for (auto f : n->getAdjListOut()) {
       if (f->getFrom() != n) continue;
-      if (_edgs.find(f) == _edgs.end()) continue;
+      if (!drawn(f)) continue;
 
       double dTot = 0;
       for (const auto& seg : cEdgSeg[f])
@@ -468,31 +487,32 @@ void Drawing::getLineGraph(LineGraph* target) const {
 }
 // _____________________________________________________________________________
 void Drawing::crumble() {
+  _undo = UndoLog();
   _c = std::numeric_limits<double>::infinity();
+  _move = 0;
+  _bend = 0;
+  _hop = 0;
+  _dense = 0;
   _violations = 0;
   _nds.clear();
   _edgs.clear();
-  _ndReachCosts.clear();
-  _ndBndCosts.clear();
-  _edgCosts.clear();
-  _vios.clear();
-  _springCosts.clear();
 }
 
 // _____________________________________________________________________________
 double Drawing::recalcBends(const CombNode* nd) {
   double c = 0;
 
-  if (_nds.count(nd) == 0) return 0;
-  auto gnd = _gg->getGrNdById(_nds.find(nd)->second);
+  auto st = findNd(nd);
+  if (!st || !st->nd) return 0;
+  auto gnd = _gg->getGrNdById(st->grNd);
 
   // TODO: implement this better
 
   for (auto e : nd->getAdjList()) {
-    if (_edgs.count(e) == 0) {
+    if (!drawn(e)) {
       continue;  // dont count edge that havent been drawn
     }
-    auto ge = _edgs.find(e)->second;
+    const auto& ge = findEdg(e)->path;
 
     size_t dirA = 0;
     for (; dirA < _gg->maxDeg(); dirA++) {
@@ -509,10 +529,10 @@ double Drawing::recalcBends(const CombNode* nd) {
     for (auto lo : e->pl().getChilds().front()->pl().getLines()) {
       for (auto f : nd->getAdjList()) {
         if (e == f) continue;
-        if (_edgs.count(f) == 0) {
+        if (!drawn(f)) {
           continue;  // dont count edges that havent been drawn
         }
-        auto gf = _edgs.find(f)->second;
+        const auto& gf = findEdg(f)->path;
 
         if (f->pl().getChilds().front()->pl().hasLine(lo.line)) {
           size_t dirB = 0;
@@ -541,50 +561,70 @@ double Drawing::recalcBends(const CombNode* nd) {
 }
 
 // _____________________________________________________________________________
-bool Drawing::drawn(const CombEdge* ce) const { return _edgs.count(ce); }
+bool Drawing::drawn(const CombEdge* ce) const {
+  auto e = findEdg(ce);
+  return e && e->edg;
+}
 
 // _____________________________________________________________________________
-const std::map<const CombEdge*, GrPath>& Drawing::getEdgPaths() const {
-  return _edgs;
+std::map<const CombEdge*, GrPath> Drawing::getEdgPaths() const {
+  std::map<const CombEdge*, GrPath> ret;
+  for (const auto& e : _edgs) {
+    if (e.edg) ret[e.edg] = e.path;
+  }
+  return ret;
 }
 
 // _____________________________________________________________________________
 void Drawing::erase(CombEdge* ce) {
-  _edgs.erase(ce);
-  _c -= _edgCosts[ce];
-  _edgCosts.erase(ce);
+  logEdg(ce);
+  logNd(ce->getFrom());
+  logNd(ce->getTo());
 
-  _c -= _springCosts[ce];
-  _springCosts.erase(ce);
+  ndSt(ce->getFrom());
+  ndSt(ce->getTo());
+  NdDrawing& frNd = _nds[ce->getFrom()->pl().getId()];
+  NdDrawing& toNd = _nds[ce->getTo()->pl().getId()];
+  EdgDrawing& edg = edgSt(ce);
 
-  _c -= _ndBndCosts[ce->getFrom()];
-  _c -= _ndBndCosts[ce->getTo()];
+  _c -= edg.cost;
+  _hop -= edg.cost;
 
-  // update bend costs
-  _ndBndCosts[ce->getFrom()] = recalcBends(ce->getFrom());
-  _ndBndCosts[ce->getTo()] = recalcBends(ce->getTo());
+  _c -= edg.springCost;
+  _dense -= edg.springCost;
+
+  _violations -= edg.vios;
+
+  edg = EdgDrawing();
+
+  _c -= frNd.bndCost;
+  _c -= toNd.bndCost;
 
-  _c += _ndBndCosts[ce->getTo()];
-  _c += _ndBndCosts[ce->getFrom()];
+  // update bend costs
+  setBndCost(&frNd, recalcBends(ce->getFrom()));
+  setBndCost(&toNd, recalcBends(ce->getTo()));
 
-  _violations -= _vios[ce];
-  _vios.erase(ce);
+  _c += toNd.bndCost;
+  _c += frNd.bndCost;
 }
 
 // _____________________________________________________________________________
 void Drawing::erase(CombNode* cn) {
-  _nds.erase(cn);
-  _c -= _ndReachCosts[cn];
-  _c -= _ndBndCosts[cn];
-  _ndReachCosts.erase(cn);
-  _ndBndCosts.erase(cn);
+  logNd(cn);
+
+  NdDrawing& nd = ndSt(cn);
+  _c -= nd.reachCost;
+  _c -= nd.bndCost;
+  _move -= nd.reachCost;
+  _bend -= nd.bndCost;
+
+  nd = NdDrawing();
 }
 
 // _____________________________________________________________________________
 void Drawing::eraseFromGrid(const CombEdge* ce, BaseGraph* gg) {
-  auto it = _edgs.find(ce);
-  if (it == _edgs.end()) return;
-  const auto& es = it->second;
+  if (!drawn(ce)) return;
+  const auto& es = findEdg(ce)->path;
   for (auto eid : es) {
     auto e = gg->getGrEdgById(eid);
     // TODO: remove const cast
@@ -595,9 +635,8 @@ void Drawing::eraseFromGrid(const CombEdge* ce, BaseGraph* gg) {
 
 // _____________________________________________________________________________
 void Drawing::applyToGrid(const CombEdge* ce, BaseGraph* gg) {
-  auto it = _edgs.find(ce);
-  if (it == _edgs.end()) return;
-  const auto& es = it->second;
+  if (!drawn(ce)) return;
+  const auto& es = findEdg(ce)->path;
 
   for (auto eid : es) {
     auto e = gg->getGrEdgById(eid);
@@ -613,36 +652,148 @@ void Drawing::eraseFromGrid(const CombNode* nd, BaseGraph* gg) {
 
 // _____________________________________________________________________________
 void Drawing::applyToGrid(const CombNode* nd, BaseGraph* gg) {
-  gg->settleNd(const_cast<GridNode*>(gg->getGrNdById(_nds[nd])),
+  auto st = findNd(nd);
+  if (!st || !st->nd) return;
+  gg->settleNd(const_cast<GridNode*>(gg->getGrNdById(st->grNd)),
                const_cast<CombNode*>(nd));
 }
 
 // _____________________________________________________________________________
 void Drawing::eraseFromGrid(BaseGraph* gg) {
-  for (auto e : _edgs) eraseFromGrid(e.first, gg);
-  for (auto nd : _nds) eraseFromGrid(nd.first, gg);
+  for (const auto& e : _edgs) {
+    if (e.edg) eraseFromGrid(e.edg, gg);
+  }
+  for (const auto& nd : _nds) {
+    if (nd.nd) eraseFromGrid(nd.nd, gg);
+  }
 }
 
 // _____________________________________________________________________________
 void Drawing::applyToGrid(BaseGraph* gg) {
-  for (auto nd : _nds) applyToGrid(nd.first, gg);
-  for (auto e : _edgs) applyToGrid(e.first, gg);
+  for (const auto& nd : _nds) {
+    if (nd.nd) applyToGrid(nd.nd, gg);
+  }
+  for (const auto& e : _edgs) {
+    if (e.edg) applyToGrid(e.edg, gg);
+  }
 }
 
 // _____________________________________________________________________________
 double Drawing::getEdgCost(const CombEdge* e) const {
-  if (_edgCosts.count(e)) return _edgCosts.find(e)->second;
+  auto edg = findEdg(e);
+  if (edg) return edg->cost;
   return 0;
 }
 
 // _____________________________________________________________________________
 double Drawing::getNdBndCost(const CombNode* n) const {
-  if (_ndBndCosts.count(n)) return _ndBndCosts.find(n)->second;
+  auto nd = findNd(n);
+  if (nd) return nd->bndCost;
   return 0;
 }
 
 // _____________________________________________________________________________
 double Drawing::getNdReachCost(const CombNode* n) const {
-  if (_ndReachCosts.count(n)) return _ndReachCosts.find(n)->second;
+  auto nd = findNd(n);
+  if (nd) return nd->reachCost;
   return 0;
 }
+
+// _____________________________________________________________________________
+NdDrawing& Drawing::ndSt(const CombNode* cn) {
+  size_t id = cn->pl().getId();
+  if (id >= _nds.size()) _nds.resize(id + 1);
+  return _nds[id];
+}
+
+// _____________________________________________________________________________
+EdgDrawing& Drawing::edgSt(const CombEdge* ce) {
+  size_t id = ce->pl().getId();
+  if (id >= _edgs.size()) _edgs.resize(id + 1);
+  return _edgs[id];
+}
+
+// _____________________________________________________________________________
+const NdDrawing* Drawing::findNd(const CombNode* cn) const {
+  size_t id = cn->pl().getId();
+  if (id >= _nds.size()) return 0;
+  return &_nds[id];
+}
+
+// _____________________________________________________________________________
+const EdgDrawing* Drawing::findEdg(const CombEdge* ce) const {
+  size_t id = ce->pl().getId();
+  if (id >= _edgs.size()) return 0;
+  return &_edgs[id];
+}
+
+// _____________________________________________________________________________
+void Drawing::setBndCost(NdDrawing* nd, double c) {
+  _bend += c - nd->bndCost;
+  nd->bndCost = c;
+}
+
+// _____________________________________________________________________________
+void Drawing::checkpoint() {
+  _undo.checkpoints.push_back({_c, _move, _bend, _hop, _dense, _violations,
+                               _undo.nds.size(), _undo.edgs.size()});
+}
+
+// _____________________________________________________________________________
+void Drawing::commit() {
+  assert(_undo.checkpoints.size());
+  _undo.checkpoints.pop_back();
+
+  // if this was the outermost transaction, the log is not needed anymore.
+  // Otherwise, the entries now belong to the enclosing transaction.
+  if (_undo.checkpoints.empty()) {
+    _undo.nds.clear();
+    _undo.edgs.clear();
+  }
+}
+
+// _____________________________________________________________________________
+void Drawing::rollback() {
+  assert(_undo.checkpoints.size());
+  const auto chkpt = _undo.checkpoints.back();
+  _undo.checkpoints.pop_back();
+
+  // restore in reverse order, so that the earliest recorded state of a node
+  // or edge is the one that survives. Entries always exist, as they were
+  // created right after the state was logged.
+  while (_undo.edgs.size() > chkpt.edgLogSize) {
+    auto& u = _undo.edgs.back();
+    std::swap(_edgs[u.id], u.st);
+    _undo.edgs.pop_back();
+  }
+
+  while (_undo.nds.size() > chkpt.ndLogSize) {
+    const auto& u = _undo.nds.back();
+    _nds[u.id] = u.st;
+    _undo.nds.pop_back();
+  }
+
+  // restoring the totals (instead of re-adding the costs) keeps them exact
+  _c = chkpt.c;
+  _move = chkpt.move;
+  _bend = chkpt.bend;
+  _hop = chkpt.hop;
+  _dense = chkpt.dense;
+  _violations = chkpt.violations;
+}
+
+// _____________________________________________________________________________
+void Drawing::logNd(const CombNode* cn) {
+  if (_undo.checkpoints.empty()) return;
+
+  auto nd = findNd(cn);
+  _undo.nds.push_back({cn->pl().getId(), nd ? *nd : NdDrawing()});
+}
+
+// _____________________________________________________________________________
+void Drawing::logEdg(const CombEdge* ce) {
+  if (_undo.checkpoints.empty()) return;
+
+  auto edg = findEdg(ce);
+  _undo.edgs.push_back({ce->pl().getId(), edg ? *edg : EdgDrawing()});
+}
@@ -2,6 +2,7 @@
 #define OCTI_COMBGRAPH_DRAWING_H_
 
 #include <map>
+#include <vector>
 #include "octi/basegraph/BaseGraph.h"
 #include "octi/combgraph/CombGraph.h"
 #include "util/graph/Dijkstra.h"
@@ -62,6 +63,65 @@ struct LineEdgeOnSeg {
   shared::linegraph::LineNode* end;
 };
 
+// drawing state of a single comb node
+struct NdDrawing {
+  NdDrawing()
+      : nd(0), grNd(0), hasReachCost(false), reachCost(0), bndCost(0) {}
+
+  // 0 if the node has not been drawn
+  const CombNode* nd;
+  size_t grNd;
+
+  bool hasReachCost;
+  double reachCost;
+  double bndCost;
+};
+
+// drawing state of a single comb edge
+struct EdgDrawing {
+  EdgDrawing() : edg(0), cost(0), springCost(0), vios(0) {}
+
+  // 0 if the edge has not been drawn
+  const CombEdge* edg;
+  GrPath path;
+
+  double cost;
+  double springCost;
+  int vios;
+};
+
+struct NdUndo {
+  size_t id;
+  NdDrawing st;
+};
+
+struct EdgUndo {
+  size_t id;
+  EdgDrawing st;
+};
+
+struct Checkpoint {
+  double c, move, bend, hop, dense;
+  size_t violations;
+  size_t ndLogSize, edgLogSize;
+};
+
+// undo log of a drawing, open transactions are never carried over to copies
+struct UndoLog {
+  UndoLog() {}
+  UndoLog(const UndoLog&) {}
+  UndoLog& operator=(const UndoLog&) {
+    nds.clear();
+    edgs.clear();
+    checkpoints.clear();
+    return *this;
+  }
+
+  std::vector<NdUndo> nds;
+  std::vector<EdgUndo> edgs;
+  std::vector<Checkpoint> checkpoints;
+};
+
 struct Segment {
   GridNode* start;
   GridNode* end;
@@ -74,9 +134,21 @@ struct Segment {
 class Drawing {
  public:
   Drawing(const BaseGraph* gg)
-      : _c(std::numeric_limits<double>::infinity()), _gg(gg), _violations(0){};
+      : _c(std::numeric_limits<double>::infinity()),
+        _move(0),
+        _bend(0),
+        _hop(0),
+        _dense(0),
+        _gg(gg),
+        _violations(0){};
   Drawing()
-      : _c(std::numeric_limits<double>::infinity()), _gg(0), _violations(0){};
+      : _c(std::numeric_limits<double>::infinity()),
+        _move(0),
+        _bend(0),
+        _hop(0),
+        _dense(0),
+        _gg(0),
+        _violations(0){};
 
   double score() const;
   double rawScore() const;
@@ -88,9 +160,18 @@ class Drawing {
   void erase(CombEdge* ce);
   void erase(CombNode* ce);
 
+  // Transactions: checkpoint() opens a (possibly nested) transaction, after
+  // which all changes by draw() and erase() are recorded. rollback() restores
+  // the drawing as it was at the matching checkpoint(), commit() keeps the
+  // changes. Only the touched comb nodes and edges are recorded, so trying a
+  // move is O(deg) instead of a full copy of the drawing.
+  void checkpoint();
+  void rollback();
+  void commit();
+
   void getLineGraph(LineGraph* target) const;
 
-  const GridNode* getGrNd(const CombNode* cn);
+  const GridNode* getGrNd(const CombNode* cn) const;
 
   bool drawn(const CombEdge* ce) const;
 
@@ -108,23 +189,35 @@ class Drawing {
 
   void setBaseGraph(const BaseGraph* gg);
 
-  const std::map<const CombEdge*, GrPath>& getEdgPaths() const;
+  std::map<const CombEdge*, GrPath> getEdgPaths() const;
 
  private:
-  std::map<const CombNode*, size_t> _nds;
-  std::map<const CombEdge*, GrPath> _edgs;
-
-  std::map<const CombNode*, double> _ndReachCosts;
-  std::map<const CombNode*, double> _ndBndCosts;
-  std::map<const CombEdge*, double> _edgCosts;
-  std::map<const CombEdge*, int> _vios;
-  std::map<const CombEdge*, double> _springCosts;
+  // indexed by the dense comb node and edge ids, grown on demand
+  std::vector<NdDrawing> _nds;
+  std::vector<EdgDrawing> _edgs;
+
   double _c;
+
+  // running totals of the single cost components
+  double _move, _bend, _hop, _dense;
+
   const BaseGraph* _gg;
 
   size_t _violations;
 
+  UndoLog _undo;
+
   double recalcBends(const CombNode* nd);
+
+  NdDrawing& ndSt(const CombNode* cn);
+  EdgDrawing& edgSt(const CombEdge* ce);
+  const NdDrawing* findNd(const CombNode* cn) const;
+  const EdgDrawing* findEdg(const CombEdge* ce) const;
+
+  void setBndCost(NdDrawing* nd, double c);
+
+  void logNd(const CombNode* nd);
+  void logEdg(const CombEdge* ce);
 };
 }  // namespace combgraph
 }  // namespace octi
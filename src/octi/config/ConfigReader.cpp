@@ -47,6 +47,10 @@ void ConfigReader::help(const char* bin) const {
             << "optimization mode, 'heur' or 'ilp'\n"
             << std::setw(39) << "  --obstacles arg"
             << "GeoJSON file containing obstacle polygons\n"
+            << std::setw(39) << "  --warm-start arg"
+            << "previous output to keep unchanged stations\n"
+            << std::setw(39) << " "
+            << " at their positions\n"
             << std::setw(39) << "  -g [ --grid-size ] arg (=100%)"
             << "grid cell length, either exact or a\n"
             << std::setw(39) << " "
@@ -64,6 +68,42 @@ void ConfigReader::help(const char* bin) const {
             << "number of threads to use by ILP solver,\n"
             << std::setw(39) << " "
             << " 0 means solver default\n"
+            << std::setw(39) << "  --threads arg (=0)"
+            << "number of threads used by heuristic approach,\n"
+            << std::setw(39) << " "
+            << " 0 means all available\n"
+            << std::setw(39) << "  --time-budget arg (=0)"
+            << "wall clock budget (ms) for the heuristic, the best\n"
+            << std::setw(39) << " "
+            << " drawing so far is kept, 0 means unlimited\n"
+            << std::setw(39) << "  --comp-threads arg (=1)"
+            << "number of input components drawn in parallel,\n"
+            << std::setw(39) << " "
+            << " always 1 with --optim-mode ilp\n"
+            << std::setw(39) << "  --comp-mem-budget arg (=0)"
+            << "estimated memory (MB) available to components\n"
+            << std::setw(39) << " "
+            << " drawn in parallel, 0 means unlimited\n"
+            << std::setw(39) << "  --pq-type arg (=radix)"
+            << "priority queue for heuristic routing,\n"
+            << std::setw(39) << " "
+            << " either radix or binary\n"
+            << std::setw(39) << "  --coarse-levels arg (=0)"
+            << "number of coarser octilinear grids to solve\n"
+            << std::setw(39) << " "
+            << " on first, each with twice the grid size\n"
+            << std::setw(39) << "  --coarse-corridor arg (=2)"
+            << "corridor width around a coarse solution,\n"
+            << std::setw(39) << " "
+            << " in coarse grid cells\n"
+            << std::setw(39) << "  --alt-landmarks arg (=0)"
+            << "number of landmarks for tighter shortest\n"
+            << std::setw(39) << " "
+            << " path bounds in heuristic routing\n"
+            << std::setw(39) << "  --grid-cache-dir arg"
+            << "directory to cache built grid graphs in\n"
+            << std::setw(39) << "  --result-cache-dir arg"
+            << "directory to cache drawn components in\n"
             << std::setw(39) << "  --hanan-iters arg (=1)"
             << "number of Hanan grid iterations\n"
             << std::setw(39) << "  --loc-search-max-iters arg (=100)"
@@ -74,6 +114,12 @@ void ConfigReader::help(const char* bin) const {
             << "ILP solve time limit (seconds), -1 for infinite\n"
             << std::setw(39) << "  --ilp-cache-dir arg (=.)"
             << "ILP cache dir\n"
+            << std::setw(39) << "  --ilp-corridor arg (=0)"
+            << "restrict ILP to corridors of this many grid cells\n"
+            << std::setw(39) << " "
+            << " around heuristic paths, 0 means no restriction\n"
+            << std::setw(39) << "  --ilp-corridor-iters arg (=3)"
+            << "max ILP solves with widened corridors\n"
             << std::setw(39) << "  --ilp-solver arg (=gurobi)"
             << "Preferred ILP solver, either glpk, cbc, or gurobi,\n"
             << std::setw(39) << " "
@@ -90,6 +136,10 @@ void ConfigReader::help(const char* bin) const {
             << "max grid distance for station candidates\n"
             << std::setw(39) << "  --restr-loc-search"
             << "restrict local search to max grid distance\n"
+            << std::setw(39) << "  --loc-search-multi"
+            << "commit all non-conflicting improvements\n"
+            << std::setw(39) << " "
+            << " per local search iteration\n"
             << std::setw(39) << "  --edge-order arg (=all)"
             << "method used for initial edge ordering for heur,\n"
             << std::setw(39) << " "
@@ -98,6 +148,10 @@ void ConfigReader::help(const char* bin) const {
             << " adj-nd-ldeg, growth-deg, growth-ldef, all\n"
             << std::setw(39) << "  --density-pen arg (=10)"
             << "restrict local search to max grid distance\n"
+            << std::setw(39) << "  --loc-search-multi"
+            << "commit all non-conflicting improvements\n"
+            << std::setw(39) << " "
+            << " per local search iteration\n"
             << std::setw(39) << "  --vert-pen arg (=0)"
             << "penalty for vertical edges\n"
             << std::setw(39) << "  --hori-pen arg (=0)"
@@ -121,6 +175,7 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
   std::string VERSION_STR = " - unversioned - ";
   std::string baseGraphStr = "octilinear";
   std::string edgeOrderMethod = "all";
+  std::string pqTypeStr = "radix";
 
   struct option ops[] = {{"version", no_argument, 0, 'v'},
                          {"help", no_argument, 0, 'h'},
@@ -154,6 +209,20 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
                          {"skip-on-error", no_argument, 0, 25},
                          {"retry-on-error", no_argument, 0, 26},
                          {"abort-after", required_argument, 0, 'a'},
+                         {"threads", required_argument, 0, 27},
+                         {"pq-type", required_argument, 0, 28},
+                         {"comp-threads", required_argument, 0, 29},
+                         {"comp-mem-budget", required_argument, 0, 30},
+                         {"time-budget", required_argument, 0, 31},
+                         {"ilp-corridor", required_argument, 0, 32},
+                         {"ilp-corridor-iters", required_argument, 0, 33},
+                         {"grid-cache-dir", required_argument, 0, 34},
+                         {"alt-landmarks", required_argument, 0, 35},
+                         {"loc-search-multi", no_argument, 0, 36},
+                         {"result-cache-dir", required_argument, 0, 37},
+                         {"warm-start", required_argument, 0, 38},
+                         {"coarse-levels", required_argument, 0, 39},
+                         {"coarse-corridor", required_argument, 0, 40},
                          {0, 0, 0, 0}};
 
   int c;
@@ -247,6 +316,48 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
       case 26:
         cfg->retryOnError = true;
         break;
+      case 27:
+        cfg->heurNumThreads = atoi(optarg);
+        break;
+      case 28:
+        pqTypeStr = optarg;
+        break;
+      case 29:
+        cfg->compThreads = atoi(optarg);
+        break;
+      case 30:
+        cfg->compMemBudget = atoi(optarg);
+        break;
+      case 31:
+        cfg->heurTimeBudget = atof(optarg);
+        break;
+      case 32:
+        cfg->ilpCorridor = atof(optarg);
+        break;
+      case 33:
+        cfg->ilpCorridorIters = atoi(optarg);
+        break;
+      case 34:
+        cfg->gridCacheDir = optarg;
+        break;
+      case 35:
+        cfg->altLandmarks = atoi(optarg);
+        break;
+      case 36:
+        cfg->multiLocSearch = true;
+        break;
+      case 37:
+        cfg->resultCacheDir = optarg;
+        break;
+      case 38:
+        cfg->prevLayoutPath = optarg;
+        break;
+      case 39:
+        cfg->coarseLevels = atoi(optarg);
+        break;
+      case 40:
+        cfg->coarseCorridor = atoi(optarg);
+        break;
       case 'g':
         cfg->gridSize = optarg;
         break;
@@ -293,6 +404,16 @@ void ConfigReader::read(Config* cfg, int argc, char** argv) const {
     exit(0);
   }
 
+  if (pqTypeStr == "radix") {
+    cfg->pqType = octi::basegraph::PQType::RADIX;
+  } else if (pqTypeStr == "binary") {
+    cfg->pqType = octi::basegraph::PQType::BINARY;
+  } else {
+    LOG(ERROR) << "Unknown priority queue type " << pqTypeStr
+               << ", must be one of {radix, binary}";
+    exit(0);
+  }
+
   if (baseGraphStr == "ortholinear") {
     cfg->baseGraphType = BaseGraphType::GRID;
   } else if (baseGraphStr == "octilinear") {
@@ -6,7 +6,9 @@
 #define OCTI_CONFIG_OCTICONFIG_H_
 
 #include <string>
+#include <unordered_map>
 #include "octi/basegraph/BaseGraph.h"
+#include "octi/basegraph/GridDijkstra.h"
 #include "octi/basegraph/GridGraph.h"
 #include "util/geo/Geo.h"
 
@@ -33,6 +35,11 @@ struct Config {
   bool fromDot = false;
   bool deg2Heur = true;
   bool restrLocSearch = false;
+
+  // commit all non-conflicting improving moves per local search iteration,
+  // instead of only the best one
+  bool multiLocSearch = false;
+
   double enfGeoPen = 0;
   bool ilpNoSolve = false;
   int ilpTimeLimit = 60;
@@ -41,6 +48,14 @@ struct Config {
   std::string ilpSolver = "gurobi";
   std::string ilpCacheDir = ".";
 
+  // width (in grid cells) of the corridor around the heuristic path of each
+  // edge the ILP is restricted to, 0 means no restriction
+  double ilpCorridor = 0;
+
+  // max number of ILP solves with doubled corridor width if the solution
+  // touches the corridor border
+  size_t ilpCorridorIters = 3;
+
   bool skipOnError = false;
   bool retryOnError = false;
 
@@ -48,6 +63,39 @@ struct Config {
 
   int heurLocSearchIters = 100;
 
+  // number of worker threads (and grid graph replicas) for the heuristic,
+  // 0 means all available
+  size_t heurNumThreads = 0;
+
+  // wall clock budget (ms) for the heuristic, 0 means unlimited
+  double heurTimeBudget = 0;
+
+  // number of coarser grids the heuristic is solved on first, and the width
+  // (in coarse cells) of the corridor around a coarse drawing the next finer
+  // grid is restricted to
+  size_t coarseLevels = 0;
+  size_t coarseCorridor = 2;
+
+  // number of input components drawn in parallel
+  size_t compThreads = 1;
+
+  // memory budget (MB) for components drawn in parallel, 0 means unlimited
+  size_t compMemBudget = 0;
+
+  // directory built grid graphs are cached in, empty means no caching
+  std::string gridCacheDir = "";
+
+  // directory drawn components are cached in, keyed by a fingerprint of the
+  // component and the settings, empty means no caching
+  std::string resultCacheDir = "";
+
+  // priority queue used by the heuristic's shortest path searches
+  octi::basegraph::PQType pqType = octi::basegraph::PQType::RADIX;
+
+  // number of landmarks for ALT lower bounds in the heuristic's shortest
+  // path searches, 0 means no landmarks
+  size_t altLandmarks = 0;
+
   size_t abortAfter = -1;
 
   size_t hananIters = 1;
@@ -58,6 +106,10 @@ struct Config {
   std::string obstaclePath;
   std::vector<util::geo::DPolygon> obstacles;
 
+  // previous output used for a warm start, station positions by station id
+  std::string prevLayoutPath;
+  std::unordered_map<std::string, util::geo::DPoint> prevLayout;
+
   octi::basegraph::BaseGraphType baseGraphType;
 
   octi::basegraph::Penalties pens;
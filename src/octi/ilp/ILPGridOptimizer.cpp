@@ -2,7 +2,10 @@
 // Chair of Algorithms and Data Structures.
 // Authors: Patrick Brosi <brosi@informatik.uni-freiburg.de>
 
+#include <algorithm>
 #include <fstream>
+#include <set>
+#include <vector>
 
 #include "octi/basegraph/BaseGraph.h"
 #include "octi/ilp/ILPGridOptimizer.h"
@@ -11,14 +14,29 @@
 #include "util/log/Log.h"
 
 using octi::basegraph::BaseGraph;
+using octi::combgraph::GrPath;
+using octi::ilp::Corridors;
 using octi::basegraph::GeoPensMap;
 using octi::basegraph::GridEdge;
 using octi::basegraph::GridNode;
 using octi::combgraph::Drawing;
 using octi::ilp::ILPGridOptimizer;
 using octi::ilp::ILPStats;
+using octi::ilp::VarIdx;
+using shared::optim::ColBatch;
+using shared::optim::IdxStarterSol;
 using shared::optim::ILPSolver;
-using shared::optim::StarterSol;
+using shared::optim::RowBatch;
+using octi::ilp::SinkIdx;
+
+// _____________________________________________________________________________
+void sortById(std::vector<const GridNode*>* nds) {
+  std::sort(nds->begin(), nds->end(),
+            [](const GridNode* a, const GridNode* b) {
+              return a->pl().getId() < b->pl().getId();
+            });
+  nds->erase(std::unique(nds->begin(), nds->end()), nds->end());
+}
 
 // _____________________________________________________________________________
 ILPStats ILPGridOptimizer::optimize(BaseGraph* gg, const CombGraph& cg,
@@ -27,10 +45,20 @@ ILPStats ILPGridOptimizer::optimize(BaseGraph* gg, const CombGraph& cg,
                                     int timeLim, const std::string& cacheDir,
                                     double cacheThreshold, int numThreads,
                                     const std::string& solverStr,
-                                    const std::string& path) const {
-  // extract first feasible solution from gridgraph
+                                    const std::string& path,
+                                    double corridorWidth,
+                                    size_t corridorIters) const {
   ILPStats s{std::numeric_limits<double>::infinity(), 0, 0, 0, 0};
-  StarterSol sol = extractFeasibleSol(d, gg, cg, maxGrDist);
+
+  // the heuristic drawing, used as a first feasible solution and to build
+  // the corridors around
+  auto paths = d->getEdgPaths();
+  std::map<const CombNode*, const GridNode*> settled;
+  for (auto nd : cg.getNds()) {
+    if (nd->getDeg() == 0) continue;
+    settled[nd] = gg->getSettled(nd);
+  }
+
   gg->reset();
 
   for (auto nd : gg->getNds()) {
@@ -48,52 +76,79 @@ ILPStats ILPGridOptimizer::optimize(BaseGraph* gg, const CombGraph& cg,
   // clear drawing
   d->crumble();
 
-  auto lp = createProblem(gg, cg, geoPensMap, maxGrDist, solverStr);
+  Corridors corridors;
+  VarIdx idx;
+  size_t round = 0;
+  ILPSolver* lp = 0;
+  SinkIdx* sinkIdx = getSinkIdx(gg);
+
+  while (true) {
+    if (corridorWidth > 0) {
+      corridors =
+          getCorridors(gg, cg, paths, corridorWidth, maxGrDist, *sinkIdx);
+      LOGTO(DEBUG, std::cerr) << "Restricting ILP to corridors of width "
+                              << corridorWidth << " around heuristic paths";
+    }
+
+    // variable names are only needed for debug output
+    lp = createProblem(gg, cg, geoPensMap, maxGrDist, solverStr, *sinkIdx,
+                       corridorWidth > 0 ? &corridors : 0, path.size() > 0,
+                       &idx);
 
-  s.cols = lp->getNumVars();
-  s.rows = lp->getNumConstrs();
+    s.cols = lp->getNumVars();
+    s.rows = lp->getNumConstrs();
 
-  lp->setStarter(sol);
+    IdxStarterSol sol = extractFeasibleSol(settled, paths, gg, cg, idx);
+    lp->setStarter(sol);
 
-  if (path.size()) {
-    std::string basename = path;
-    size_t pos = basename.find_last_of(".");
-    if (pos != std::string::npos) basename = basename.substr(0, pos);
+    if (path.size()) {
+      std::string basename = path;
+      size_t pos = basename.find_last_of(".");
+      if (pos != std::string::npos) basename = basename.substr(0, pos);
 
-    std::string outf = basename + ".sol";
-    std::string solutionF = basename + ".mst";
-    lp->writeMst(solutionF, sol);
-    lp->writeMps(path);
-  }
+      std::string outf = basename + ".sol";
+      std::string solutionF = basename + ".mst";
+      lp->writeMst(solutionF, sol);
+      lp->writeMps(path);
+    }
 
-  double time;
+    if (noSolve) break;
 
-  if (!noSolve) {
     if (timeLim >= 0) lp->setTimeLim(timeLim);
     if (cacheDir.size()) lp->setCacheDir(cacheDir);
     lp->setCacheThreshold(cacheThreshold);
     if (numThreads != 0) lp->setNumThreads(numThreads);
     T_START(ilp);
     auto status = lp->solve();
-    time = T_STOP(ilp);
+    s.time += T_STOP(ilp);
 
     if (status == shared::optim::SolveType::INF) {
       delete lp;
+      delete sinkIdx;
       throw std::runtime_error(
           "No solution found for ILP problem (most likely because of a time "
           "limit)!");
     }
 
-    extractSolution(lp, gg, cg, d);
+    if (corridorWidth > 0 && ++round < corridorIters &&
+        touchesBorder(lp, gg, cg, corridors, idx)) {
+      // the solution may be restricted by the corridor, widen it
+      corridorWidth *= 2;
+      delete lp;
+      continue;
+    }
+
+    extractSolution(lp, gg, cg, d, idx);
     shared::linegraph::LineGraph tg;
     d->getLineGraph(&tg);
 
     s.score = lp->getObjVal();
-    s.time = time;
     s.optimal = (status == shared::optim::SolveType::OPTIM);
+    break;
   }
 
   delete lp;
+  delete sinkIdx;
 
   return s;
 }
@@ -102,58 +157,96 @@ ILPStats ILPGridOptimizer::optimize(BaseGraph* gg, const CombGraph& cg,
 ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
                                            const GeoPensMap* geoPensMap,
                                            double maxGrDist,
-                                           const std::string& solverStr) const {
+                                           const std::string& solverStr,
+                                           const SinkIdx& sinkIdx,
+                                           const Corridors* corridors,
+                                           bool names, VarIdx* idx) const {
   ILPSolver* lp = shared::optim::getSolver(solverStr, shared::optim::MIN);
 
+  *idx = VarIdx();
+  idx->edgUse.assign(cg.numEdgIds(), {});
+  idx->statPos.assign(cg.numNdIds(), {});
+  idx->edgUseEdgs.assign(cg.numEdgIds(), {});
+  idx->statPosNds.assign(cg.numNdIds(), {});
+
+  auto inCorridor = [corridors](const GridNode* n, const CombEdge* edg) {
+    if (!corridors) return true;
+    return (*corridors)[edg->pl().getId()].count(n->pl().getParent()) > 0;
+  };
+
   // grid nodes that may potentially be a position for an
   // input station
   std::map<const CombNode*, std::set<const GridNode*>> cands;
 
+  ColBatch statPosCols;
+  RowBatch oneAssRows;
+  int firstCol = lp->getNumVars();
+
   for (auto nd : cg.getNds()) {
     if (nd->getDeg() == 0) continue;
-    std::stringstream oneAssignment;
     // must sum up to 1
-    oneAssignment << "oneass(" << nd << ")";
-    int rowStat = lp->addRow(oneAssignment.str(), 1, shared::optim::FIX);
-
-    for (const GridNode* n : gg->getNds()) {
-      if (!n->pl().isSink()) continue;
+    oneAssRows.add(1, shared::optim::FIX);
+    if (names) {
+      std::stringstream oneAssignment;
+      oneAssignment << "oneass(" << nd << ")";
+      oneAssRows.names.push_back(oneAssignment.str());
+    }
 
+    for (const GridNode* n : getCands(gg, nd, maxGrDist, sinkIdx)) {
       // don't use nodes as candidates which cannot hold the comb node due to
       // their degree
       if (n->getDeg() < nd->getDeg()) {
         continue;
       }
 
-      double gridD = dist(*n->pl().getGeom(), *nd->pl().getGeom());
-
-      // threshold for speedup
-      double maxDis = gg->getCellSize() * maxGrDist;
-      if (gridD >= maxDis) {
-        continue;
-      }
-
       cands[nd].insert(n);
 
       gg->openSinkFr(const_cast<GridNode*>(n), 0);
       gg->openSinkTo(const_cast<GridNode*>(n), 0);
 
-      auto varName = getStatPosVar(n, nd);
+      int col = firstCol + statPosCols.size();
+      idx->addStatPos(n, nd, col);
+      statPosCols.add(shared::optim::BIN, gg->ndMovePen(nd, n));
+      if (names) statPosCols.names.push_back(getStatPosVar(n, nd));
 
-      int col = lp->addCol(varName, shared::optim::BIN, gg->ndMovePen(nd, n));
-
-      lp->addColToRow(rowStat, col, 1);
+      oneAssRows.addCoef(col, 1);
     }
   }
 
+  lp->addCols(statPosCols);
+  lp->addRows(oneAssRows);
+
   // for every edge, we define a binary variable telling us whether this edge
   // is used in a path for the original edge
+  ColBatch edgUseCols;
+  firstCol = lp->getNumVars();
+
   for (auto nd : cg.getNds()) {
     for (auto edg : nd->getAdjList()) {
       if (edg->getFrom() != nd) continue;
-      for (const GridNode* n : gg->getNds()) {
+
+      // with corridors, only the grid nodes inside the corridor are
+      // considered, ordered by id to keep the model deterministic
+      std::vector<const GridNode*> grNds;
+      if (corridors) {
+        for (auto sink : (*corridors)[edg->pl().getId()]) {
+          grNds.push_back(sink);
+          for (size_t p = 0; p < gg->maxDeg(); p++) {
+            if (sink->pl().getPort(p)) grNds.push_back(sink->pl().getPort(p));
+          }
+        }
+        std::sort(grNds.begin(), grNds.end(),
+                  [](const GridNode* a, const GridNode* b) {
+                    return a->pl().getId() < b->pl().getId();
+                  });
+      } else {
+        grNds.insert(grNds.end(), gg->getNds().begin(), gg->getNds().end());
+      }
+
+      for (const GridNode* n : grNds) {
         for (const GridEdge* e : n->getAdjList()) {
           if (e->getFrom() != n) continue;
+          if (!inCorridor(e->getTo(), edg)) continue;
           if (e->pl().cost() >= basegraph::SOFT_INF) {
             // skip infinite edges, we cannot use them.
             // this also skips sink edges of nodes not used as
@@ -171,14 +264,12 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
             continue;
           }
 
-          auto edgeVarName = getEdgUseVar(e, edg);
-
           double coef;
           if (geoPensMap && !e->pl().isSecondary()) {
             // add geo pen
-            auto thisMap = geoPensMap->find(edg)->second;
-            auto i = thisMap.find(e->pl().getId());
-            if (i != thisMap.end()) coef = e->pl().cost() + i->second;
+            auto thisMap = geoPensMap->row(edg->pl().getId());
+            float pen;
+            if (thisMap.get(e->pl().getId(), &pen)) coef = e->pl().cost() + pen;
 
             // if no geopen was present for grid edge, we assume SOFT_INF
             // penalty
@@ -186,59 +277,99 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
           } else {
             coef = e->pl().cost();
           }
-          lp->addCol(edgeVarName, shared::optim::BIN, coef);
+
+          idx->addEdgUse(e, edg, firstCol + edgUseCols.size());
+          edgUseCols.add(shared::optim::BIN, coef);
+          if (names) edgUseCols.names.push_back(getEdgUseVar(e, edg));
         }
       }
     }
   }
 
-  lp->update();
+  lp->addCols(edgUseCols);
 
-  // an edge can only be used a single time
-  std::set<const GridEdge*> proced;
-  for (const GridNode* n : gg->getNds()) {
-    for (const GridEdge* e : n->getAdjList()) {
-      if (e->pl().isSecondary()) continue;
-      if (proced.count(e)) continue;
-      auto f = gg->getEdg(e->getTo(), e->getFrom());
-      proced.insert(e);
-      proced.insert(f);
+  lp->update();
 
-      std::stringstream constName;
-      constName << "ue(" << e->getFrom()->pl().getId() << ","
-                << e->getTo()->pl().getId() << ")";
-      int row = lp->addRow(constName.str(), 1, shared::optim::UP);
+  // the grid nodes each comb edge may touch - the end nodes of its edge use
+  // variables and the station candidates of its end nodes - and all grid
+  // edges with an edge use variable. Only these get constraints, ordered by
+  // id to keep the model deterministic
+  std::vector<std::vector<const GridNode*>> edgNds(cg.numEdgIds());
+  std::vector<const GridNode*> sinks;
+  std::vector<const GridEdge*> grEdgs;
 
-      for (auto nd : cg.getNds()) {
-        for (auto edg : nd->getAdjList()) {
-          if (edg->getFrom() != nd) continue;
-          if (e->pl().cost() >= basegraph::SOFT_INF) continue;
+  for (auto nd : cg.getNds()) {
+    for (auto edg : nd->getAdjList()) {
+      if (edg->getFrom() != nd) continue;
+      auto& nds = edgNds[edg->pl().getId()];
 
-          auto eVarName = getEdgUseVar(e, edg);
-          auto fVarName = getEdgUseVar(f, edg);
+      for (auto e : idx->edgUseEdgs[edg->pl().getId()]) {
+        nds.push_back(e->getFrom());
+        nds.push_back(e->getTo());
+        grEdgs.push_back(e);
+      }
 
-          int eCol = lp->getVarByName(eVarName);
-          if (eCol > -1) lp->addColToRow(row, eCol, 1);
-          int fCol = lp->getVarByName(fVarName);
-          if (fCol > -1) lp->addColToRow(row, fCol, 1);
-        }
+      for (auto cnd : {edg->getFrom(), edg->getTo()}) {
+        const auto& c = idx->statPosNds[cnd->pl().getId()];
+        nds.insert(nds.end(), c.begin(), c.end());
       }
+
+      sortById(&nds);
+      for (auto n : nds) sinks.push_back(n->pl().getParent());
+    }
+  }
+
+  sortById(&sinks);
+  std::sort(grEdgs.begin(), grEdgs.end(),
+            [](const GridEdge* a, const GridEdge* b) {
+              return a->pl().getId() < b->pl().getId();
+            });
+  grEdgs.erase(std::unique(grEdgs.begin(), grEdgs.end()), grEdgs.end());
+
+  auto addGrEdgCoefs = [idx](const GridEdge* e, RowBatch* rows) {
+    auto cols = idx->grEdgCols.find(e->pl().getId());
+    if (cols == idx->grEdgCols.end()) return;
+    for (int col : cols->second) rows->addCoef(col, 1);
+  };
+
+  // an edge can only be used a single time
+  RowBatch rows;
+  std::unordered_set<const GridEdge*> proced;
+  for (const GridEdge* e : grEdgs) {
+    if (e->pl().isSecondary()) continue;
+    if (proced.count(e)) continue;
+    auto f = gg->getEdg(e->getTo(), e->getFrom());
+    proced.insert(e);
+    proced.insert(f);
+
+    rows.add(1, shared::optim::UP);
+    if (names) {
+      std::stringstream constName;
+      constName << "ue(" << e->getFrom()->pl().getId() << ","
+                << e->getTo()->pl().getId() << ")";
+      rows.names.push_back(constName.str());
     }
+
+    addGrEdgCoefs(e, &rows);
+    if (f) addGrEdgCoefs(f, &rows);
   }
 
   // for every node, the number of outgoing and incoming used edges must be
   // the same, except for the start and end node
-  for (const GridNode* n : gg->getNds()) {
-    if (nonInfDeg(n) == 0) continue;
+  for (auto nd : cg.getNds()) {
+    for (auto edg : nd->getAdjList()) {
+      if (edg->getFrom() != nd) continue;
 
-    for (auto nd : cg.getNds()) {
-      for (auto edg : nd->getAdjList()) {
-        if (edg->getFrom() != nd) continue;
-        std::stringstream constName;
-        constName << "as(" << n->pl().getId() << "," << edg << ")";
+      for (const GridNode* n : edgNds[edg->pl().getId()]) {
+        if (nonInfDeg(n) == 0) continue;
 
         // an upper bound is enough here
-        int row = lp->addRow(constName.str(), 0, shared::optim::UP);
+        rows.add(0, shared::optim::UP);
+        if (names) {
+          std::stringstream constName;
+          constName << "as(" << n->pl().getId() << "," << edg << ")";
+          rows.names.push_back(constName.str());
+        }
 
         // normally, we count an incoming edge as 1 and an outgoing edge as -1
         // later on, we make sure that each node has a some of all out and in
@@ -262,98 +393,97 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
         if (n->pl().isSink()) {
           // subtract the variable for this start node and edge, if used
           // as a candidate
-          int ndColFrom = lp->getVarByName(getStatPosVar(n, edg->getFrom()));
-          if (ndColFrom > -1) lp->addColToRow(row, ndColFrom, -2);
+          int ndColFrom = idx->statPosCol(n, edg->getFrom());
+          if (ndColFrom > -1) rows.addCoef(ndColFrom, -2);
 
           // add the variable for this end node and edge, if used
           // as a candidate
-          int ndColTo = lp->getVarByName(getStatPosVar(n, edg->getTo()));
-          if (ndColTo > -1) lp->addColToRow(row, ndColTo, 1);
+          int ndColTo = idx->statPosCol(n, edg->getTo());
+          if (ndColTo > -1) rows.addCoef(ndColTo, 1);
 
           outCost = 2;
         }
 
         for (auto e : n->getAdjListIn()) {
-          int edgCol = lp->getVarByName(getEdgUseVar(e, edg));
+          int edgCol = idx->edgUseCol(e, edg);
           if (edgCol < 0) continue;
-          lp->addColToRow(row, edgCol, inCost);
+          rows.addCoef(edgCol, inCost);
         }
 
         for (auto e : n->getAdjListOut()) {
-          int edgCol = lp->getVarByName(getEdgUseVar(e, edg));
+          int edgCol = idx->edgUseCol(e, edg);
           if (edgCol < 0) continue;
-          lp->addColToRow(row, edgCol, outCost);
+          rows.addCoef(edgCol, outCost);
         }
+
+        rows.dropEmpty();
       }
     }
   }
 
+  lp->addRows(rows);
+  rows = RowBatch();
+
   lp->update();
 
   // only a single sink edge can be activated per input edge and settled grid
   // node
   // THIS RULE IS REDUNDANT AND IMPLICITELY ENFORCED BY OTHER RULES,
   // BUT SEEMS TO LEAD TO FASTER SOLUTION TIMES
-  for (GridNode* n : gg->getNds()) {
-    if (!n->pl().isSink()) continue;
-
-    for (auto nd : cg.getNds()) {
-      for (auto e : nd->getAdjList()) {
-        if (e->getFrom() != nd) continue;
-
-        std::stringstream constName;
-        constName << "ss(" << n->pl().getId() << "," << e << ")";
+  for (auto nd : cg.getNds()) {
+    for (auto e : nd->getAdjList()) {
+      if (e->getFrom() != nd) continue;
 
-        int row = lp->addRow(constName.str(), 0, shared::optim::FIX);
+      for (const GridNode* n : edgNds[e->pl().getId()]) {
+        if (!n->pl().isSink()) continue;
 
-        if (!cands[e->getFrom()].count(n) && !cands[e->getTo()].count(n)) {
-          // node does not appear as start or end cand, so the number of
-          // sink edges for this node is 0
+        rows.add(0, shared::optim::FIX);
+        if (names) {
+          std::stringstream constName;
+          constName << "ss(" << n->pl().getId() << "," << e << ")";
+          rows.names.push_back(constName.str());
+        }
 
-        } else {
-          if (cands[e->getTo()].count(n)) {
-            int ndColTo = lp->getVarByName(getStatPosVar(n, e->getTo()));
-            if (ndColTo > -1) lp->addColToRow(row, ndColTo, -1);
-          }
+        // if the node does not appear as a start or end cand, the number of
+        // sink edges for this node is 0
+        int ndColTo = idx->statPosCol(n, e->getTo());
+        if (ndColTo > -1) rows.addCoef(ndColTo, -1);
 
-          if (cands[e->getFrom()].count(n)) {
-            int ndColFr = lp->getVarByName(getStatPosVar(n, e->getFrom()));
-            if (ndColFr > -1) lp->addColToRow(row, ndColFr, -1);
-          }
-        };
+        int ndColFr = idx->statPosCol(n, e->getFrom());
+        if (ndColFr > -1) rows.addCoef(ndColFr, -1);
 
+        auto sink = const_cast<GridNode*>(n);
         for (size_t p = 0; p < gg->maxDeg(); p++) {
           auto portNd = n->pl().getPort(p);
           if (!portNd) continue;
-          auto varSinkTo = getEdgUseVar(gg->getEdg(portNd, n), e);
-          auto varSinkFr = getEdgUseVar(gg->getEdg(n, portNd), e);
+          int ndColTo = idx->edgUseCol(gg->getEdg(portNd, sink), e);
+          if (ndColTo > -1) rows.addCoef(ndColTo, 1);
 
-          int ndColTo = lp->getVarByName(varSinkTo);
-          if (ndColTo > -1) lp->addColToRow(row, ndColTo, 1);
-
-          int ndColFr = lp->getVarByName(varSinkFr);
-          if (ndColFr > -1) lp->addColToRow(row, ndColFr, 1);
+          int ndColFr = idx->edgUseCol(gg->getEdg(sink, portNd), e);
+          if (ndColFr > -1) rows.addCoef(ndColFr, 1);
         }
+
+        rows.dropEmpty();
       }
     }
   }
 
   // a grid node can either be an activated sink, or a single pass through
   // edge is used
-  for (GridNode* n : gg->getNds()) {
-    if (!n->pl().isSink()) continue;
-
-    std::stringstream constName;
-    constName << "iu(" << n->pl().getId() << ")";
-
-    int row = lp->addRow(constName.str(), 1, shared::optim::UP);
+  for (const GridNode* n : sinks) {
+    rows.add(1, shared::optim::UP);
+    if (names) {
+      std::stringstream constName;
+      constName << "iu(" << n->pl().getId() << ")";
+      rows.names.push_back(constName.str());
+    }
 
     // a meta grid node can either be a sink for a single input node, or
     // a pass-through
 
-    for (auto nd : cg.getNds()) {
-      int ndcolto = lp->getVarByName(getStatPosVar(n, nd).c_str());
-      if (ndcolto > -1) lp->addColToRow(row, ndcolto, 1);
+    auto cols = idx->grNdCols.find(n->pl().getId());
+    if (cols != idx->grNdCols.end()) {
+      for (int col : cols->second) rows.addCoef(col, 1);
     }
 
     // go over all ports
@@ -365,49 +495,39 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
         if (!to || from == to) continue;
 
         auto innerE = gg->getEdg(from, to);
-        for (auto nd : cg.getNds()) {
-          for (auto edg : nd->getAdjList()) {
-            if (edg->getFrom() != nd) continue;
-
-            int edgCol = lp->getVarByName(getEdgUseVar(innerE, edg));
-            if (edgCol < 0) continue;
-            lp->addColToRow(row, edgCol, 1);
-          }
-        }
+        if (innerE) addGrEdgCoefs(innerE, &rows);
       }
     }
+
+    rows.dropEmpty();
   }
 
+  lp->addRows(rows);
+  rows = RowBatch();
+
   lp->update();
 
   // dont allow crossing edges
   size_t rowId = 0;
   for (auto edgPair : gg->getCrossEdgPairs()) {
-    std::stringstream constName;
-    constName << "nc(" << rowId << ")";
+    rows.add(1, shared::optim::UP);
+    if (names) {
+      std::stringstream constName;
+      constName << "nc(" << rowId << ")";
+      rows.names.push_back(constName.str());
+    }
     rowId++;
 
-    int row = lp->addRow(constName.str(), 1, shared::optim::UP);
-
-    for (auto nd : cg.getNds()) {
-      for (auto edg : nd->getAdjList()) {
-        if (edg->getFrom() != nd) continue;
-
-        int col = lp->getVarByName(getEdgUseVar(edgPair.first.first, edg));
-        if (col > -1) lp->addColToRow(row, col, 1);
-
-        col = lp->getVarByName(getEdgUseVar(edgPair.first.second, edg));
-        if (col > -1) lp->addColToRow(row, col, 1);
+    addGrEdgCoefs(edgPair.first.first, &rows);
+    addGrEdgCoefs(edgPair.first.second, &rows);
+    addGrEdgCoefs(edgPair.second.first, &rows);
+    addGrEdgCoefs(edgPair.second.second, &rows);
 
-        col = lp->getVarByName(getEdgUseVar(edgPair.second.first, edg));
-        if (col > -1) lp->addColToRow(row, col, 1);
-
-        col = lp->getVarByName(getEdgUseVar(edgPair.second.second, edg));
-        if (col > -1) lp->addColToRow(row, col, 1);
-      }
-    }
+    rows.dropEmpty();
   }
 
+  lp->addRows(rows);
+
   lp->update();
 
   // for each input node N, define a var x_dirNE which tells the direction of
@@ -427,21 +547,16 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
 
       lp->addColToRow(row, col, -1);
 
-      for (GridNode* n : gg->getNds()) {
-        if (!n->pl().isSink()) continue;
-
-        // check if this grid node is used as a candidate for comb node
-        // if not, we don't have to add the constraints
-        int ndColFrom = lp->getVarByName(getStatPosVar(n, nd));
-        if (ndColFrom == -1) continue;
-
+      // only the candidates for comb node nd
+      for (const GridNode* cand : idx->statPosNds[nd->pl().getId()]) {
+        auto n = const_cast<GridNode*>(cand);
         if (edg->getFrom() == nd) {
           // the 0 can be skipped here
           for (size_t i = 1; i < gg->maxDeg(); i++) {
             auto portNd = n->pl().getPort(i);
             if (!portNd) continue;
             auto e = gg->getEdg(n, portNd);
-            int col = lp->getVarByName(getEdgUseVar(e, edg));
+            int col = idx->edgUseCol(e, edg);
             if (col > -1) lp->addColToRow(row, col, i);
           }
         } else {
@@ -450,7 +565,7 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
             auto portNd = n->pl().getPort(i);
             if (!portNd) continue;
             auto e = gg->getEdg(portNd, n);
-            int col = lp->getVarByName(getEdgUseVar(e, edg));
+            int col = idx->edgUseCol(e, edg);
             if (col > -1) lp->addColToRow(row, col, i);
           }
         }
@@ -620,6 +735,38 @@ ILPSolver* ILPGridOptimizer::createProblem(BaseGraph* gg, const CombGraph& cg,
   return lp;
 }
 
+// _____________________________________________________________________________
+void VarIdx::addEdgUse(const GridEdge* e, const CombEdge* edg, int col) {
+  edgUse[edg->pl().getId()][e->pl().getId()] = col;
+  edgUseEdgs[edg->pl().getId()].push_back(e);
+  grEdgCols[e->pl().getId()].push_back(col);
+}
+
+// _____________________________________________________________________________
+void VarIdx::addStatPos(const GridNode* n, const CombNode* nd, int col) {
+  statPos[nd->pl().getId()][n->pl().getId()] = col;
+  statPosNds[nd->pl().getId()].push_back(n);
+  grNdCols[n->pl().getId()].push_back(col);
+}
+
+// _____________________________________________________________________________
+int VarIdx::edgUseCol(const GridEdge* e, const CombEdge* edg) const {
+  if (edg->pl().getId() >= edgUse.size()) return -1;
+  const auto& cols = edgUse[edg->pl().getId()];
+  auto i = cols.find(e->pl().getId());
+  if (i == cols.end()) return -1;
+  return i->second;
+}
+
+// _____________________________________________________________________________
+int VarIdx::statPosCol(const GridNode* n, const CombNode* nd) const {
+  if (nd->pl().getId() >= statPos.size()) return -1;
+  const auto& cols = statPos[nd->pl().getId()];
+  auto i = cols.find(n->pl().getId());
+  if (i == cols.end()) return -1;
+  return i->second;
+}
+
 // _____________________________________________________________________________
 std::string ILPGridOptimizer::getEdgUseVar(const GridEdge* e,
                                            const CombEdge* cg) const {
@@ -642,44 +789,31 @@ std::string ILPGridOptimizer::getStatPosVar(const GridNode* n,
 // _____________________________________________________________________________
 void ILPGridOptimizer::extractSolution(ILPSolver* lp, BaseGraph* gg,
                                        const CombGraph& cg,
-                                       combgraph::Drawing* d) const {
+                                       combgraph::Drawing* d,
+                                       const VarIdx& idx) const {
   std::map<const CombNode*, const GridNode*> gridNds;
   std::map<const CombEdge*, std::set<const GridEdge*>> gridEdgs;
 
   // write solution to grid graph
-  for (GridNode* n : gg->getNds()) {
-    for (GridEdge* e : n->getAdjList()) {
-      if (e->getFrom() != n) continue;
-
-      for (auto nd : cg.getNds()) {
-        for (auto edg : nd->getAdjList()) {
-          if (edg->getFrom() != nd) continue;
-          auto varName = getEdgUseVar(e, edg);
-
-          int i = lp->getVarByName(varName);
-          if (i > -1) {
-            double val = lp->getVarVal(i);
-            if (val > 0.5) {
-              gg->addResEdg(e, edg);
-              gridEdgs[edg].insert(e);
-            }
-          }
+  for (auto nd : cg.getNds()) {
+    for (auto edg : nd->getAdjList()) {
+      if (edg->getFrom() != nd) continue;
+
+      for (auto e : idx.edgUseEdgs[edg->pl().getId()]) {
+        double val = lp->getVarVal(idx.edgUseCol(e, edg));
+        if (val > 0.5) {
+          gg->addResEdg(const_cast<GridEdge*>(e), edg);
+          gridEdgs[edg].insert(e);
         }
       }
     }
   }
 
-  for (GridNode* n : gg->getNds()) {
-    if (!n->pl().isSink()) continue;
-    for (auto nd : cg.getNds()) {
-      auto varName = getStatPosVar(n, nd);
-
-      int i = lp->getVarByName(varName);
-      if (i > -1) {
-        double val = lp->getVarVal(i);
-        if (val > 0.5) {
-          gridNds[nd] = n;
-        }
+  for (auto nd : cg.getNds()) {
+    for (auto n : idx.statPosNds[nd->pl().getId()]) {
+      double val = lp->getVarVal(idx.statPosCol(n, nd));
+      if (val > 0.5) {
+        gridNds[nd] = n;
       }
     }
   }
@@ -744,26 +878,24 @@ size_t ILPGridOptimizer::nonInfDeg(const GridNode* g) const {
 }
 
 // _____________________________________________________________________________
-StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
-                                                const CombGraph& cg,
-                                                double maxGrDist) const {
-  StarterSol sol;
+IdxStarterSol ILPGridOptimizer::extractFeasibleSol(
+    const std::map<const CombNode*, const GridNode*>& settled,
+    const std::map<const CombEdge*, GrPath>& paths, BaseGraph* gg,
+    const CombGraph& cg, const VarIdx& idx) const {
+  // later values overwrite earlier ones
+  std::map<int, double> vals;
+  auto set = [&vals](int col, double val) {
+    if (col > -1) vals[col] = val;
+  };
 
   for (auto nd : cg.getNds()) {
     if (nd->getDeg() == 0) continue;
-    auto settled = gg->getSettled(nd);
-
-    for (auto gnd : gg->getNds()) {
-      if (!gnd->pl().isSink()) continue;
-      double gridD = dist(*nd->pl().getGeom(), *gnd->pl().getGeom());
-
-      // threshold for speedup
-      double maxDis = gg->getCellSize() * maxGrDist;
-      if (gridD >= maxDis) continue;
+    auto stl = settled.find(nd);
 
-      auto varName = getStatPosVar(gnd, nd);
-      if (gnd == settled) {
-        sol[varName] = 1;
+    for (auto gnd : idx.statPosNds[nd->pl().getId()]) {
+      int col = idx.statPosCol(gnd, nd);
+      if (stl != settled.end() && gnd == stl->second) {
+        set(col, 1);
 
         // if settled, all bend edges are unused
         for (size_t p = 0; p < gg->maxDeg(); p++) {
@@ -773,13 +905,12 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
             if (!bendEdg->pl().isSecondary()) continue;
             for (auto cEdg : nd->getAdjList()) {
               if (cEdg->getFrom() != nd) continue;
-              auto varName = getEdgUseVar(bendEdg, cEdg);
-              sol[varName] = 0;
+              set(idx.edgUseCol(bendEdg, cEdg), 0);
             }
           }
         }
       } else {
-        sol[varName] = 0;
+        set(col, 0);
 
         // if not settled, all sink edges are unused
         // for all input edges
@@ -787,8 +918,7 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
           assert(sinkEdg->pl().isSecondary());
           for (auto cEdg : nd->getAdjList()) {
             if (cEdg->getFrom() != nd) continue;
-            auto varName = getEdgUseVar(sinkEdg, cEdg);
-            sol[varName] = 0;
+            set(idx.edgUseCol(sinkEdg, cEdg), 0);
           }
         }
       }
@@ -796,32 +926,159 @@ StarterSol ILPGridOptimizer::extractFeasibleSol(Drawing* d, BaseGraph* gg,
   }
 
   // init edge use vars to 0
-  for (auto grNd : gg->getNds()) {
-    for (auto grEdg : grNd->getAdjListOut()) {
-      if (grEdg->pl().isSecondary()) continue;
-
-      for (auto cNd : cg.getNds()) {
-        for (auto cEdg : cNd->getAdjList()) {
-          if (cEdg->getFrom() != cNd) continue;
-          auto varName = getEdgUseVar(grEdg, cEdg);
-          sol[varName] = 0;
-        }
+  for (auto cNd : cg.getNds()) {
+    for (auto cEdg : cNd->getAdjList()) {
+      if (cEdg->getFrom() != cNd) continue;
+      for (auto grEdg : idx.edgUseEdgs[cEdg->pl().getId()]) {
+        if (grEdg->pl().isSecondary()) continue;
+        set(idx.edgUseCol(grEdg, cEdg), 0);
       }
     }
   }
 
   // write edge use vars from heuristic solution
-  for (const auto& a : d->getEdgPaths()) {
+  for (const auto& a : paths) {
     auto cEdg = a.first;
     const auto& grEdgList = a.second;
     for (auto xy : grEdgList) {
       auto grEdg = gg->getGrEdgById(xy);
-      auto varName = getEdgUseVar(grEdg, cEdg);
-      sol[varName] = 1;
+      set(idx.edgUseCol(grEdg, cEdg), 1);
     }
   }
 
   // TODO: we don't write the bend edge variables here, these can
   // typically be filled by the solver using the information given above
-  return sol;
+  return IdxStarterSol(vals.begin(), vals.end());
+}
+
+// _____________________________________________________________________________
+Corridors ILPGridOptimizer::getCorridors(
+    BaseGraph* gg, const CombGraph& cg,
+    const std::map<const CombEdge*, GrPath>& paths, double width,
+    double maxGrDist, const SinkIdx& sinkIdx) const {
+  Corridors ret(cg.numEdgIds());
+
+  double rad = width * gg->getCellSize();
+
+  for (auto nd : cg.getNds()) {
+    for (auto edg : nd->getAdjList()) {
+      if (edg->getFrom() != nd) continue;
+      auto& cor = ret[edg->pl().getId()];
+
+      std::vector<util::geo::DLine> lines;
+
+      auto p = paths.find(edg);
+      if (p != paths.end() && p->second.size()) {
+        util::geo::DLine l;
+        for (auto xy : p->second) {
+          auto a = gg->getGrNdById(xy.first)->pl().getParent();
+          auto b = gg->getGrNdById(xy.second)->pl().getParent();
+          l.push_back(*a->pl().getGeom());
+          l.push_back(*b->pl().getGeom());
+        }
+        lines.push_back(l);
+      } else {
+        for (auto orE : edg->pl().getChilds()) {
+          lines.push_back(*orE->pl().getGeom());
+        }
+      }
+
+      std::set<const GridNode*> near;
+
+      for (const auto& l : lines) {
+        near.clear();
+        sinkIdx.get(
+            util::geo::pad(util::geo::extendBox(l, util::geo::DBox()), rad),
+            &near);
+        for (auto n : near) {
+          if (util::geo::dist(*n->pl().getGeom(), l) <= rad) cor.insert(n);
+        }
+      }
+
+      // the station candidates of both end nodes, see createProblem()
+      for (auto cnd : {edg->getFrom(), edg->getTo()}) {
+        for (auto n : getCands(gg, cnd, maxGrDist, sinkIdx)) cor.insert(n);
+      }
+    }
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+std::vector<const GridNode*> ILPGridOptimizer::getCands(
+    const BaseGraph* gg, const CombNode* nd, double maxGrDist,
+    const SinkIdx& sinkIdx) const {
+  double maxDis = gg->getCellSize() * maxGrDist;
+  auto geom = *nd->pl().getGeom();
+
+  std::set<const GridNode*> near;
+  sinkIdx.get(
+      util::geo::pad(util::geo::extendBox(geom, util::geo::DBox()), maxDis),
+      &near);
+
+  std::vector<const GridNode*> ret;
+  for (auto n : near) {
+    if (util::geo::dist(*n->pl().getGeom(), geom) < maxDis) ret.push_back(n);
+  }
+
+  sortById(&ret);
+  return ret;
+}
+
+// _____________________________________________________________________________
+SinkIdx* ILPGridOptimizer::getSinkIdx(const BaseGraph* gg) const {
+  util::geo::DBox bbox;
+  for (const GridNode* n : gg->getNds()) {
+    if (!n->pl().isSink()) continue;
+    bbox = util::geo::extendBox(*n->pl().getGeom(), bbox);
+  }
+
+  SinkIdx* ret =
+      new SinkIdx(gg->getCellSize(), gg->getCellSize(), bbox, false);
+
+  for (const GridNode* n : gg->getNds()) {
+    if (!n->pl().isSink()) continue;
+    ret->add(*n->pl().getGeom(), n);
+  }
+
+  return ret;
+}
+
+// _____________________________________________________________________________
+bool ILPGridOptimizer::touchesBorder(ILPSolver* lp, BaseGraph* gg,
+                                     const CombGraph& cg,
+                                     const Corridors& corridors,
+                                     const VarIdx& idx) const {
+  for (auto nd : cg.getNds()) {
+    for (auto edg : nd->getAdjList()) {
+      if (edg->getFrom() != nd) continue;
+      const auto& cor = corridors[edg->pl().getId()];
+
+      for (auto n : cor) {
+        // a border node has a neighbor outside the corridor
+        bool border = false;
+        for (size_t i = 0; i < gg->maxDeg(); i++) {
+          auto neigh = gg->neigh(n, i);
+          if (neigh && !cor.count(neigh)) {
+            border = true;
+            break;
+          }
+        }
+
+        if (!border) continue;
+
+        for (size_t p = 0; p < gg->maxDeg(); p++) {
+          auto port = n->pl().getPort(p);
+          if (!port) continue;
+          for (auto e : port->getAdjList()) {
+            int col = idx.edgUseCol(e, edg);
+            if (col > -1 && lp->getVarVal(col) > 0.5) return true;
+          }
+        }
+      }
+    }
+  }
+
+  return false;
 }
@@ -5,11 +5,15 @@
 #ifndef OCTI_ILP_ILPGRIDOPTIMIZER_H_
 #define OCTI_ILP_ILPGRIDOPTIMIZER_H_
 
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "octi/basegraph/BaseGraph.h"
 #include "octi/combgraph/CombGraph.h"
 #include "octi/combgraph/Drawing.h"
 #include "shared/optim/ILPSolver.h"
+#include "util/geo/Grid.h"
 
 using octi::basegraph::BaseGraph;
 using octi::basegraph::GridEdge;
@@ -43,6 +47,42 @@ inline ILPStats operator+(const ILPStats& lh, const ILPStats& rh) {
   return ret;
 }
 
+// per comb edge (indexed by comb edge id), the sink grid nodes whose ports
+// and sink edges may be used by its path
+typedef std::vector<std::unordered_set<const GridNode*>> Corridors;
+
+// spatial index over the sink nodes of a grid graph
+typedef util::geo::Grid<const GridNode*, util::geo::Point, double> SinkIdx;
+
+// column ids of the edge use and station position variables, which make up
+// nearly the entire model and are added without names
+struct VarIdx {
+  // per comb edge id, grid edge id -> column id
+  std::vector<std::unordered_map<size_t, int>> edgUse;
+
+  // per comb node id, grid node id -> column id
+  std::vector<std::unordered_map<size_t, int>> statPos;
+
+  // per comb edge id, the grid edges with an edge use variable
+  std::vector<std::vector<const GridEdge*>> edgUseEdgs;
+
+  // per comb node id, the station candidates
+  std::vector<std::vector<const GridNode*>> statPosNds;
+
+  // grid edge id -> edge use columns of all comb edges
+  std::unordered_map<size_t, std::vector<int>> grEdgCols;
+
+  // grid node id -> station position columns of all comb nodes
+  std::unordered_map<size_t, std::vector<int>> grNdCols;
+
+  void addEdgUse(const GridEdge* e, const CombEdge* edg, int col);
+  void addStatPos(const GridNode* n, const CombNode* nd, int col);
+
+  // -1 if there is no such variable
+  int edgUseCol(const GridEdge* e, const CombEdge* edg) const;
+  int statPosCol(const GridNode* n, const CombNode* nd) const;
+};
+
 class ILPGridOptimizer {
  public:
   ILPGridOptimizer() {}
@@ -52,24 +92,50 @@ class ILPGridOptimizer {
                     const basegraph::GeoPensMap* geoPensMap, int timeLim,
                     const std::string& cacheDir, double cacheThreshold,
                     int numThreads, const std::string& solverStr,
-                    const std::string& path) const;
+                    const std::string& path, double corridorWidth,
+                    size_t corridorIters) const;
 
  protected:
   shared::optim::ILPSolver* createProblem(
       BaseGraph* gg, const CombGraph& cg,
       const basegraph::GeoPensMap* geoPensMap, double maxGrDist,
-      const std::string& solverStr) const;
+      const std::string& solverStr, const SinkIdx& sinkIdx,
+      const Corridors* corridors, bool names, VarIdx* idx) const;
+
+  // grid nodes within width grid cells of the heuristic path of each comb
+  // edge (or of its input geometry, if there is no such path), plus the
+  // station candidates of its end nodes
+  Corridors getCorridors(
+      BaseGraph* gg, const CombGraph& cg,
+      const std::map<const CombEdge*, combgraph::GrPath>& paths, double width,
+      double maxGrDist, const SinkIdx& sinkIdx) const;
+
+  // sink nodes within maxGrDist grid cells of comb node nd, ordered by id
+  std::vector<const GridNode*> getCands(const BaseGraph* gg,
+                                        const CombNode* nd, double maxGrDist,
+                                        const SinkIdx& sinkIdx) const;
+
+  SinkIdx* getSinkIdx(const BaseGraph* gg) const;
+
+  // true if a solution path uses a grid node at the corridor border, which
+  // means a wider corridor might give a better solution
+  bool touchesBorder(shared::optim::ILPSolver* lp, BaseGraph* gg,
+                     const CombGraph& cg, const Corridors& corridors,
+                     const VarIdx& idx) const;
 
   std::string getEdgUseVar(const GridEdge* e, const CombEdge* cg) const;
   std::string getStatPosVar(const GridNode* e, const CombNode* cg) const;
 
   void extractSolution(shared::optim::ILPSolver* lp, BaseGraph* gg,
-                       const CombGraph& cg, combgraph::Drawing* d) const;
-
-  shared::optim::StarterSol extractFeasibleSol(combgraph::Drawing* d,
-                                               BaseGraph* gg,
-                                               const CombGraph& cg,
-                                               double maxGrDist) const;
+                       const CombGraph& cg, combgraph::Drawing* d,
+                       const VarIdx& idx) const;
+
+  // the heuristic drawing, given by its settled station positions and its
+  // paths, as a starter solution for the model indexed by idx
+  shared::optim::IdxStarterSol extractFeasibleSol(
+      const std::map<const CombNode*, const GridNode*>& settled,
+      const std::map<const CombEdge*, combgraph::GrPath>& paths, BaseGraph* gg,
+      const CombGraph& cg, const VarIdx& idx) const;
 
   size_t nonInfDeg(const GridNode* g) const;
 };
@@ -0,0 +1,202 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "octi/Octilinearizer.h"
+#include "octi/combgraph/CombGraph.h"
+#include "octi/combgraph/Drawing.h"
+#include "octi/tests/DrawingTest.h"
+#include "shared/linegraph/LineGraph.h"
+#include "util/Misc.h"
+
+using octi::Octilinearizer;
+using octi::basegraph::BaseGraph;
+using octi::combgraph::CombEdge;
+using octi::combgraph::CombGraph;
+using octi::combgraph::Drawing;
+using octi::combgraph::GrEdgList;
+using octi::combgraph::Score;
+using shared::linegraph::LineGraph;
+
+// _____________________________________________________________________________
+double avgEdgLen(const LineGraph& g) {
+  double len = 0;
+  size_t n = 0;
+  for (auto nd : g.getNds()) {
+    for (auto e : nd->getAdjList()) {
+      if (e->getFrom() != nd) continue;
+      len += util::geo::dist(*e->getFrom()->pl().getGeom(),
+                             *e->getTo()->pl().getGeom());
+      n++;
+    }
+  }
+  return len / n;
+}
+
+// _____________________________________________________________________________
+void testSameScore(const Score& a, const Score& b) {
+  TEST(a.full, ==, b.full);
+  TEST(a.move, ==, b.move);
+  TEST(a.bend, ==, b.bend);
+  TEST(a.hop, ==, b.hop);
+  TEST(a.dense, ==, b.dense);
+  TEST(a.violations, ==, b.violations);
+}
+
+// _____________________________________________________________________________
+void testSameDrawing(const Drawing& a, const Drawing& b) {
+  testSameScore(a.fullScore(), b.fullScore());
+  TEST(a.score(), ==, b.score());
+  TEST(a.violations(), ==, b.violations());
+  TEST(a.getEdgPaths() == b.getEdgPaths());
+}
+
+// _____________________________________________________________________________
+void testTransactions(const std::string& path) {
+  LineGraph tg;
+  std::ifstream input;
+  input.open(path);
+  tg.readFromJson(&input, true);
+
+  double gridSize = avgEdgLen(tg);
+  CombGraph cg(&tg, true);
+  auto box = util::geo::pad(tg.getBBox(), gridSize + 1);
+
+  Octilinearizer oct(octi::basegraph::BaseGraphType::OCTIGRID);
+  LineGraph out;
+  BaseGraph* gg = 0;
+  Drawing d;
+  octi::HeurStats stats;
+
+  oct.draw(cg, box, &out, &gg, &d, octi::basegraph::Penalties(), gridSize,
+           45, 3, octi::config::OrderMethod::NUM_LINES, false, false, 0, 1,
+           {}, {}, 100, -1, 1, 0, &stats);
+
+  std::vector<CombEdge*> drawn;
+  for (auto nd : cg.getNds()) {
+    for (auto e : nd->getAdjList()) {
+      if (e->getFrom() == nd && d.drawn(e)) drawn.push_back(e);
+    }
+  }
+
+  TEST(drawn.size(), >, 1);
+
+  CombEdge* a = drawn.front();
+  CombEdge* b = drawn.back();
+
+  // the grid path of b, used to redraw a somewhere else
+  GrEdgList bPath;
+  auto paths = d.getEdgPaths();
+  for (const auto& eid : paths[b]) {
+    bPath.push_back(const_cast<octi::basegraph::GridEdge*>(
+        gg->getGrEdgById(eid)));
+  }
+
+  const Drawing before = d;
+
+  // ___________________________________________________________________________
+  // erase, redraw and roll back
+  {
+    d.checkpoint();
+    d.erase(a);
+    TEST(!d.drawn(a));
+    d.draw(a, bPath, false);
+    TEST(d.drawn(a));
+    TEST(d.getEdgPaths() != before.getEdgPaths());
+    d.rollback();
+
+    testSameDrawing(d, before);
+  }
+
+  // ___________________________________________________________________________
+  // nested rollbacks restore the state of their own checkpoint
+  {
+    d.checkpoint();
+    d.erase(a);
+    d.draw(a, bPath, false);
+    const Drawing redrawn = d;
+
+    d.checkpoint();
+    d.erase(b);
+    d.erase(b->getFrom());
+    d.erase(a);
+    d.rollback();
+
+    testSameDrawing(d, redrawn);
+
+    d.rollback();
+
+    testSameDrawing(d, before);
+  }
+
+  // ___________________________________________________________________________
+  // a committed inner transaction is rolled back with the outer one
+  {
+    d.checkpoint();
+    d.erase(a);
+
+    d.checkpoint();
+    d.erase(b);
+    d.erase(b->getTo());
+    d.commit();
+
+    TEST(!d.drawn(a));
+    TEST(!d.drawn(b));
+
+    d.rollback();
+
+    testSameDrawing(d, before);
+  }
+
+  // ___________________________________________________________________________
+  // committed changes are kept
+  {
+    Drawing ref = before;
+    ref.erase(a);
+
+    d.checkpoint();
+    d.erase(a);
+    d.commit();
+
+    testSameDrawing(d, ref);
+
+    d = before;
+    testSameDrawing(d, before);
+  }
+
+  // ___________________________________________________________________________
+  // copies never carry over open transactions
+  {
+    d.checkpoint();
+    d.erase(a);
+
+    Drawing cp = d;
+    Drawing assigned;
+    assigned = d;
+
+    d.rollback();
+    testSameDrawing(d, before);
+
+    // the copies keep the erased edge
+    TEST(!cp.drawn(a));
+    TEST(!assigned.drawn(a));
+
+    // and a transaction on a copy only reaches back to the copy
+    Drawing cpBefore = cp;
+    cp.checkpoint();
+    cp.erase(b);
+    cp.rollback();
+    testSameDrawing(cp, cpBefore);
+  }
+
+  delete gg;
+}
+
+// _____________________________________________________________________________
+void DrawingTest::run() {
+  testTransactions("../src/loom/tests/datasets/y-splitting-6.json");
+  testTransactions("../src/loom/tests/datasets/freiburg-tram.json");
+}
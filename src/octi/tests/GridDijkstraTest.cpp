@@ -0,0 +1,116 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "octi/basegraph/GridDijkstra.h"
+#include "octi/basegraph/GridGraph.h"
+#include "octi/basegraph/OctiGridGraph.h"
+#include "octi/tests/GridDijkstraTest.h"
+#include "util/Misc.h"
+
+using octi::basegraph::BINARY;
+using octi::basegraph::GridCost;
+using octi::basegraph::GridDijkstra;
+using octi::basegraph::GridNode;
+using octi::basegraph::OctiGridGraph;
+using octi::basegraph::Penalties;
+using octi::basegraph::RADIX;
+using util::approx;
+
+typedef util::graph::EList<octi::basegraph::GridNodePL,
+                           octi::basegraph::GridEdgePL>
+    EList;
+typedef util::graph::NList<octi::basegraph::GridNodePL,
+                           octi::basegraph::GridEdgePL>
+    NList;
+
+// _____________________________________________________________________________
+double pathCost(const EList& eL) {
+  double ret = 0;
+  for (auto e : eL) ret += e->pl().cost();
+  return ret;
+}
+
+// _____________________________________________________________________________
+void testSamePathCosts(size_t cells, size_t seed) {
+  double cellSize = 10;
+  util::geo::DBox box(util::geo::DPoint(0, 0),
+                      util::geo::DPoint(cellSize * cells, cellSize * cells));
+
+  OctiGridGraph g(box, cellSize, 0, Penalties());
+  g.init();
+
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> noise(0, 3);
+
+  // non-integer costs on all open non-sink edges, so that keys differ in
+  // their lower bits
+  std::vector<GridNode*> sinks;
+  for (auto n : g.getNds()) {
+    if (n->pl().isSink()) {
+      sinks.push_back(n);
+      continue;
+    }
+    for (auto e : n->getAdjListOut()) {
+      if (e->getTo()->pl().isSink()) continue;
+      if (e->pl().cost() == octi::basegraph::INF) continue;
+      e->pl().setCost(e->pl().cost() + noise(rng));
+    }
+  }
+
+  TEST(sinks.size(), ==, cells * cells);
+
+  GridDijkstra bin(&g, BINARY);
+  GridDijkstra rad(&g, RADIX);
+
+  std::uniform_int_distribution<size_t> pick(0, sinks.size() - 1);
+
+  for (size_t i = 0; i < 200; i++) {
+    GridNode* fr = sinks[pick(rng)];
+    GridNode* to = sinks[pick(rng)];
+    if (fr == to) continue;
+
+    std::set<GridNode*> frS{fr};
+    std::set<GridNode*> toS{to};
+
+    g.openSinkFr(fr, 0.5);
+    g.openSinkTo(to, 0.5);
+
+    auto heur = g.getHeur(toS);
+    GridCost cost(std::numeric_limits<float>::infinity());
+
+    EList binEL, radEL;
+    NList binNL, radNL;
+
+    float binC = bin.shortestPath(frS, toS, cost, *heur, &binEL, &binNL);
+    float radC = rad.shortestPath(frS, toS, cost, *heur, &radEL, &radNL);
+
+    delete heur;
+
+    // both searches must find a path of the same cost, which must also be
+    // the cost of the returned edges
+    TEST(binNL.size(), >, 0);
+    TEST(radNL.size(), >, 0);
+    TEST(radNL.front(), ==, to);
+    TEST(radNL.back(), ==, fr);
+    TEST(radC, ==, approx(binC));
+    TEST(pathCost(radEL), ==, approx(radC));
+    TEST(pathCost(binEL), ==, approx(binC));
+
+    g.closeSinkFr(fr);
+    g.closeSinkTo(to);
+  }
+
+  TEST(rad.numSearches(), ==, bin.numSearches());
+  TEST(bin.numFallbacks(), ==, 0);
+}
+
+// _____________________________________________________________________________
+void GridDijkstraTest::run() {
+  testSamePathCosts(8, 1);
+  testSamePathCosts(15, 2);
+}
@@ -0,0 +1,12 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#ifndef OCTI_TEST_GRIDDIJKSTRATEST_H_
+#define OCTI_TEST_GRIDDIJKSTRATEST_H_
+
+class GridDijkstraTest {
+  public:
+    void run();
+};
+
+#endif
@@ -0,0 +1,143 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "octi/basegraph/GridDijkstra.h"
+#include "octi/basegraph/GridGraph.h"
+#include "octi/basegraph/GridLandmarks.h"
+#include "octi/basegraph/OctiGridGraph.h"
+#include "octi/tests/GridLandmarksTest.h"
+#include "util/Misc.h"
+
+using octi::basegraph::BINARY;
+using octi::basegraph::GridCost;
+using octi::basegraph::GridDijkstra;
+using octi::basegraph::GridHeurFunc;
+using octi::basegraph::GridLandmarks;
+using octi::basegraph::GridNode;
+using octi::basegraph::OctiGridGraph;
+using octi::basegraph::Penalties;
+
+typedef util::graph::EList<octi::basegraph::GridNodePL,
+                           octi::basegraph::GridEdgePL>
+    EList;
+typedef util::graph::NList<octi::basegraph::GridNodePL,
+                           octi::basegraph::GridEdgePL>
+    NList;
+
+// true distances are summed up as floats by GridDijkstra, allow for their
+// rounding error
+const static double EPS = 1e-4;
+
+struct ZeroHeur : public GridHeurFunc {
+  float operator()(const GridNode* from, const std::set<GridNode*>& to) const {
+    UNUSED(from);
+    UNUSED(to);
+    return 0;
+  }
+};
+
+// _____________________________________________________________________________
+float trueDist(GridDijkstra* search, GridNode* fr,
+               const std::set<GridNode*>& to) {
+  EList eL;
+  NList nL;
+  GridCost cost(std::numeric_limits<float>::infinity());
+  return search->shortestPath({fr}, to, cost, ZeroHeur(), &eL, &nL);
+}
+
+// _____________________________________________________________________________
+void writeNoise(OctiGridGraph* g, std::mt19937* rng, double max) {
+  std::uniform_real_distribution<double> noise(0, max);
+  for (auto n : g->getNds()) {
+    if (n->pl().isSink()) continue;
+    for (auto e : n->getAdjListOut()) {
+      if (e->getTo()->pl().isSink()) continue;
+      if (e->pl().cost() == octi::basegraph::INF) continue;
+      e->pl().setCost(e->pl().cost() + noise(*rng));
+    }
+  }
+}
+
+// _____________________________________________________________________________
+void testAdmissible(size_t cells, size_t seed) {
+  double cellSize = 10;
+  util::geo::DBox box(util::geo::DPoint(0, 0),
+                      util::geo::DPoint(cellSize * cells, cellSize * cells));
+
+  OctiGridGraph g(box, cellSize, 0, Penalties());
+  g.init();
+
+  std::mt19937 rng(seed);
+  writeNoise(&g, &rng, 3);
+
+  std::vector<GridNode*> sinks, ports;
+  for (auto n : g.getNds()) {
+    if (n->pl().isSink()) {
+      sinks.push_back(n);
+    } else {
+      ports.push_back(n);
+    }
+  }
+
+  GridDijkstra search(&g, BINARY);
+  GridLandmarks lms(&g, 6);
+
+  TEST(lms.size(), ==, 6);
+  TEST(lms.memUsage(), >=, 6 * ports.size() * sizeof(double));
+
+  std::uniform_int_distribution<size_t> pickPort(0, ports.size() - 1);
+  std::uniform_int_distribution<size_t> pickSink(0, sinks.size() - 1);
+
+  // ___________________________________________________________________________
+  // dist(l, v) - dist(l, u) is a lower bound for d(u, v)
+  for (size_t i = 0; i < 300; i++) {
+    GridNode* u = ports[pickPort(rng)];
+    GridNode* v = ports[pickPort(rng)];
+
+    float d = trueDist(&search, u, {v});
+    if (d == std::numeric_limits<float>::infinity()) continue;
+
+    for (size_t l = 0; l < lms.size(); l++) {
+      if (lms.dist(l, u) == std::numeric_limits<double>::infinity()) continue;
+      TEST(lms.dist(l, v) - lms.dist(l, u), <=, d + EPS);
+    }
+  }
+
+  // routing only raises costs, which must keep the heuristic admissible
+  g.writeLandmarks(6);
+  writeNoise(&g, &rng, 2);
+
+  // ___________________________________________________________________________
+  // the landmark heuristic never overestimates the distance to a target cell
+  for (size_t i = 0; i < 30; i++) {
+    GridNode* to = sinks[pickSink(rng)];
+    std::set<GridNode*> toS{to};
+
+    g.openSinkTo(to, 0.5);
+    auto heur = g.getHeur(toS);
+
+    for (size_t j = 0; j < 20; j++) {
+      GridNode* u = ports[pickPort(rng)];
+      if (u->pl().getParent() == to) continue;
+
+      float d = trueDist(&search, u, toS);
+      if (d == std::numeric_limits<float>::infinity()) continue;
+
+      TEST((*heur)(u, toS), <=, d + EPS);
+    }
+
+    delete heur;
+    g.closeSinkTo(to);
+  }
+}
+
+// _____________________________________________________________________________
+void GridLandmarksTest::run() {
+  testAdmissible(8, 1);
+  testAdmissible(14, 2);
+}
@@ -0,0 +1,12 @@
+// Copyright 2016
+// Author: Patrick Brosi
+
+#ifndef OCTI_TEST_GRIDLANDMARKSTEST_H_
+#define OCTI_TEST_GRIDLANDMARKSTEST_H_
+
+class GridLandmarksTest {
+  public:
+    void run();
+};
+
+#endif
@@ -1,12 +1,23 @@
 // Copyright 2016
 // Author: Patrick Brosi
 
+#include "octi/tests/DrawingTest.h"
+#include "octi/tests/GridDijkstraTest.h"
+#include "octi/tests/GridLandmarksTest.h"
+
 #include "util/Misc.h"
 
 // _____________________________________________________________________________
 int main(int argc, char** argv) {
   UNUSED(argc);
   UNUSED(argv);
+  DrawingTest dt;
+  GridDijkstraTest gdt;
+  GridLandmarksTest glt;
+
+  dt.run();
+  gdt.run();
+  glt.run();
 
   return 0;
 }
@@ -7,6 +7,9 @@
 #include <cassert>
 #include <sstream>
 #include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 // COIN includes
 #include "CbcSolver.hpp"
@@ -47,6 +50,7 @@ int callBack(CbcModel* model, int from) {
 // _____________________________________________________________________________
 COINSolver::COINSolver(DirType dir)
     : _starterArr(0),
+      _starterSize(0),
       _status(INF),
       _timeLimit(std::numeric_limits<int>::max()),
       _numThreads(0),
@@ -144,6 +148,44 @@ int COINSolver::addRow(const std::string& name, double bnd, RowType rowType) {
   return rowId;
 }
 
+// _____________________________________________________________________________
+int COINSolver::addCols(const ColBatch& cols) {
+  int first = _model.numberColumns();
+
+  for (size_t i = 0; i < cols.size(); i++) {
+    _model.addCol(0, NULL, NULL, cols.lowBnds[i], cols.upBnds[i],
+                  cols.objCoefs[i],
+                  cols.names.size() ? cols.names[i].c_str() : NULL);
+    if (cols.types[i] == CONT) {
+      _model.setContinuous(first + i);
+    } else {
+      _model.setInteger(first + i);
+    }
+  }
+
+  return first;
+}
+
+// _____________________________________________________________________________
+int COINSolver::addRows(const RowBatch& rows) {
+  int first = _model.numberRows();
+
+  for (size_t i = 0; i < rows.size(); i++) {
+    double lo = -COIN_DBL_MAX;
+    double up = COIN_DBL_MAX;
+    if (rows.types[i] != UP) lo = rows.bnds[i];
+    if (rows.types[i] != LO) up = rows.bnds[i];
+
+    // the row is added together with its coefficients
+    _model.addRow(rows.starts[i + 1] - rows.starts[i],
+                  rows.cols.data() + rows.starts[i],
+                  rows.coefs.data() + rows.starts[i], lo, up,
+                  rows.names.size() ? rows.names[i].c_str() : NULL);
+  }
+
+  return first;
+}
+
 // _____________________________________________________________________________
 void COINSolver::addColToRow(const std::string& rowName,
                              const std::string& colName, double coef) {
@@ -160,6 +202,13 @@ int COINSolver::getConstrByName(const std::string& name) const {
   return _model.row(name.c_str());
 }
 
+// _____________________________________________________________________________
+std::string COINSolver::getVarName(int colId) const {
+  const char* ret = _model.getColumnName(colId);
+  if (!ret) return "";
+  return ret;
+}
+
 // _____________________________________________________________________________
 void COINSolver::addColToRow(int rowId, int colId, double coef) {
   _model.setElement(rowId, colId, coef);
@@ -175,6 +224,16 @@ SolveType COINSolver::solve() {
   _solver1.getModelPtr()->setMoreSpecialOptions(3);
   _cbcModel = CbcModel(_solver1);
 
+  if (_starterArr) {
+    // picked up by CbcMain1 like a start given with -mips on the command
+    // line, columns are matched by their names in the solver
+    std::vector<std::pair<std::string, double>> mipStart;
+    for (int i = 0; i < _starterSize && i < _solver1.getNumCols(); i++) {
+      mipStart.push_back({_solver1.getColName(i), _starterArr[i]});
+    }
+    _cbcModel.setMIPStart(mipStart);
+  }
+
   _cbcModel.setMaximumSeconds(_timeLimit);
   _cbcModel.setUseElapsedTime(true);
 
@@ -257,8 +316,23 @@ int COINSolver::getNumVars() const { return _model.numberColumns(); }
 
 // _____________________________________________________________________________
 void COINSolver::setStarter(const StarterSol& starterSol) {
-  // TODO: not yet implemented
-  UNUSED(starterSol);
+  IdxStarterSol idxSol;
+  for (const auto& varVal : starterSol) {
+    idxSol.push_back({getVarByName(varVal.first), varVal.second});
+  }
+  setStarter(idxSol);
+}
+
+// _____________________________________________________________________________
+void COINSolver::setStarter(const IdxStarterSol& starterSol) {
+  if (_starterArr) delete[] _starterArr;
+  _starterSize = getNumVars();
+  _starterArr = new double[_starterSize]();
+
+  for (const auto& varVal : starterSol) {
+    if (varVal.first < 0 || varVal.first >= _starterSize) continue;
+    _starterArr[varVal.first] = varVal.second;
+  }
 }
 
 // _____________________________________________________________________________
@@ -31,12 +31,16 @@ class COINSolver : public ILPSolver {
              double lowBnd, double upBnd);
   int addRow(const std::string& name, double bnd, RowType rowType);
 
+  int addCols(const ColBatch& cols);
+  int addRows(const RowBatch& rows);
+
   void addColToRow(const std::string& rowName, const std::string& colName,
                    double coef);
   void addColToRow(int rowId, int colId, double coef);
 
   int getVarByName(const std::string& name) const;
   int getConstrByName(const std::string& name) const;
+  std::string getVarName(int colId) const;
 
   double getVarVal(int colId) const;
   double getVarVal(const std::string& name) const;
@@ -66,12 +70,14 @@ class COINSolver : public ILPSolver {
   int getNumThreads() const;
 
   void setStarter(const StarterSol& starterSol);
+  void setStarter(const IdxStarterSol& starterSol);
   void writeMps(const std::string& path) const;
 
   double* getStarterArr() const;
 
  private:
   double* _starterArr;
+  int _starterSize;
 
   SolveType _status;
 
@@ -48,75 +48,117 @@ GLPKSolver::~GLPKSolver() {
 }
 
 // _____________________________________________________________________________
-int GLPKSolver::addCol(const std::string& name, ColType colType,
-                       double objCoef) {
-  int vtype = 0;
+int GLPKSolver::colKind(ColType colType) {
   switch (colType) {
     case INT:
-      vtype = GLP_IV;
-      break;
+      return GLP_IV;
     case BIN:
-      vtype = GLP_BV;
-      break;
+      return GLP_BV;
     case CONT:
-      vtype = GLP_CV;
-      break;
+    default:
+      return GLP_CV;
   }
-
-  int col = glp_add_cols(_prob, 1);
-  glp_set_col_name(_prob, col, name.c_str());
-  glp_set_col_kind(_prob, col, vtype);
-  glp_set_obj_coef(_prob, col, objCoef);
-
-  return col - 1;
 }
 
 // _____________________________________________________________________________
-int GLPKSolver::addCol(const std::string& name, ColType colType, double objCoef,
-                       double lowBnd, double upBnd) {
-  int rtype = 0;
+int GLPKSolver::bndType(double lowBnd, double upBnd) {
   if (lowBnd <= -std::numeric_limits<double>::max() &&
       upBnd >= std::numeric_limits<double>::max()) {
-    rtype = GLP_FR;
+    return GLP_FR;
   } else if (lowBnd <= -std::numeric_limits<double>::max()) {
-    rtype = GLP_UP;
+    return GLP_UP;
   } else if (upBnd >= std::numeric_limits<double>::max()) {
-    rtype = GLP_LO;
+    return GLP_LO;
   } else if (lowBnd == upBnd) {
-    rtype = GLP_FX;
-  } else {
-    rtype = GLP_DB;
+    return GLP_FX;
   }
-
-  int col = addCol(name, colType, objCoef);
-  glp_set_col_bnds(_prob, col + 1, rtype, lowBnd, upBnd);
-
-  return col;
+  return GLP_DB;
 }
 
 // _____________________________________________________________________________
-int GLPKSolver::addRow(const std::string& name, double bnd, RowType rowType) {
-  int rtype = 0;
+int GLPKSolver::rowBndType(RowType rowType) {
   switch (rowType) {
     case FIX:
-      rtype = GLP_FX;
-      break;
+      return GLP_FX;
     case UP:
-      rtype = GLP_UP;
-      break;
+      return GLP_UP;
     case LO:
-      rtype = GLP_LO;
-      break;
+    default:
+      return GLP_LO;
   }
+}
+
+// _____________________________________________________________________________
+int GLPKSolver::addCol(const std::string& name, ColType colType,
+                       double objCoef) {
+  int col = glp_add_cols(_prob, 1);
+  glp_set_col_name(_prob, col, name.c_str());
+  glp_set_col_kind(_prob, col, colKind(colType));
+  glp_set_obj_coef(_prob, col, objCoef);
 
+  return col - 1;
+}
+
+// _____________________________________________________________________________
+int GLPKSolver::addCol(const std::string& name, ColType colType, double objCoef,
+                       double lowBnd, double upBnd) {
+  int col = addCol(name, colType, objCoef);
+  glp_set_col_bnds(_prob, col + 1, bndType(lowBnd, upBnd), lowBnd, upBnd);
+
+  return col;
+}
+
+// _____________________________________________________________________________
+int GLPKSolver::addRow(const std::string& name, double bnd, RowType rowType) {
   int row = glp_add_rows(_prob, 1);
   assert(row);
   glp_set_row_name(_prob, row, name.c_str());
-  glp_set_row_bnds(_prob, row, rtype, bnd, bnd);
+  glp_set_row_bnds(_prob, row, rowBndType(rowType), bnd, bnd);
 
   return row - 1;
 }
 
+// _____________________________________________________________________________
+int GLPKSolver::addCols(const ColBatch& cols) {
+  if (cols.size() == 0) return getNumVars();
+
+  int first = glp_add_cols(_prob, cols.size());
+
+  for (size_t i = 0; i < cols.size(); i++) {
+    int col = first + i;
+    if (cols.names.size()) glp_set_col_name(_prob, col, cols.names[i].c_str());
+    glp_set_col_kind(_prob, col, colKind(cols.types[i]));
+    glp_set_obj_coef(_prob, col, cols.objCoefs[i]);
+    glp_set_col_bnds(_prob, col, bndType(cols.lowBnds[i], cols.upBnds[i]),
+                     cols.lowBnds[i], cols.upBnds[i]);
+  }
+
+  return first - 1;
+}
+
+// _____________________________________________________________________________
+int GLPKSolver::addRows(const RowBatch& rows) {
+  if (rows.size() == 0) return getNumConstrs();
+
+  int first = glp_add_rows(_prob, rows.size());
+
+  // the coefficients are only collected here and loaded into the problem
+  // in a single glp_load_matrix() call before solving
+  _vm.reserve(_vm.getNumVars() + rows.cols.size());
+
+  for (size_t i = 0; i < rows.size(); i++) {
+    int row = first + i;
+    if (rows.names.size()) glp_set_row_name(_prob, row, rows.names[i].c_str());
+    glp_set_row_bnds(_prob, row, rowBndType(rows.types[i]), rows.bnds[i],
+                     rows.bnds[i]);
+    for (size_t j = rows.starts[i]; j < rows.starts[i + 1]; j++) {
+      _vm.addVar(row, rows.cols[j] + 1, rows.coefs[j]);
+    }
+  }
+
+  return first - 1;
+}
+
 // _____________________________________________________________________________
 void GLPKSolver::addColToRow(const std::string& rowName,
                              const std::string& colName, double coef) {
@@ -146,6 +188,13 @@ int GLPKSolver::getConstrByName(const std::string& name) const {
   return ret - 1;
 }
 
+// _____________________________________________________________________________
+std::string GLPKSolver::getVarName(int colId) const {
+  const char* ret = glp_get_col_name(_prob, colId + 1);
+  if (!ret) return "";
+  return ret;
+}
+
 // _____________________________________________________________________________
 void GLPKSolver::addColToRow(int rowId, int colId, double coef) {
   _vm.addVar(rowId + 1, colId + 1, coef);
@@ -316,6 +365,24 @@ void GLPKSolver::setStarter(const StarterSol& starterSol) {
   }
 }
 
+// _____________________________________________________________________________
+void GLPKSolver::setStarter(const IdxStarterSol& starterSol) {
+  if (_starterArr) delete[] _starterArr;
+  _starterArr = new double[getNumVars() + 1]();
+
+  for (const auto& varVal : starterSol) {
+    if (varVal.first < 0 || varVal.first >= getNumVars()) continue;
+    _starterArr[varVal.first + 1] = varVal.second;
+  }
+}
+
+// _____________________________________________________________________________
+void VariableMatrix::reserve(size_t n) {
+  rowNum.reserve(n);
+  colNum.reserve(n);
+  vals.reserve(n);
+}
+
 // _____________________________________________________________________________
 void VariableMatrix::addVar(int row, int col, double val) {
   rowNum.push_back(row);
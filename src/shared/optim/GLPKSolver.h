@@ -21,6 +21,7 @@ struct VariableMatrix {
   std::vector<double> vals;
 
   void addVar(int row, int col, double val);
+  void reserve(size_t n);
   void getGLPKArrs(int** ia, int** ja, double** r) const;
   size_t getNumVars() const { return vals.size(); }
 };
@@ -35,12 +36,16 @@ class GLPKSolver : public ILPSolver {
              double lowBnd, double upBnd);
   int addRow(const std::string& name, double bnd, RowType rowType);
 
+  int addCols(const ColBatch& cols);
+  int addRows(const RowBatch& rows);
+
   void addColToRow(const std::string& rowName, const std::string& colName,
                    double coef);
   void addColToRow(int rowId, int colId, double coef);
 
   int getVarByName(const std::string& name) const;
   int getConstrByName(const std::string& name) const;
+  std::string getVarName(int colId) const;
 
   double getVarVal(int colId) const;
   double getVarVal(const std::string& name) const;
@@ -70,6 +75,7 @@ class GLPKSolver : public ILPSolver {
   double getCacheThreshold() const;
 
   void setStarter(const StarterSol& starterSol);
+  void setStarter(const IdxStarterSol& starterSol);
   void writeMps(const std::string& path) const;
 
   double* getStarterArr() const;
@@ -86,6 +92,10 @@ class GLPKSolver : public ILPSolver {
 
   std::string _termBuf;
 
+  static int colKind(ColType colType);
+  static int bndType(double lowBnd, double upBnd);
+  static int rowBndType(RowType rowType);
+
   static void optCb(glp_tree* tree, void* solver);
   static int termHook(void* info, const char* str);
   static void errorHook(void* info);
@@ -6,6 +6,7 @@
 
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 #include "gurobi_c.h"
 #include "shared/optim/GurobiSolver.h"
 #include "util/Misc.h"
@@ -123,6 +124,84 @@ int GurobiSolver::addRow(const std::string& name, double bnd, RowType rowType) {
   return _numRows - 1;
 }
 
+// _____________________________________________________________________________
+int GurobiSolver::addCols(const ColBatch& cols) {
+  if (cols.size() == 0) return _numVars;
+
+  std::vector<char> vtypes(cols.size());
+  for (size_t i = 0; i < cols.size(); i++) {
+    switch (cols.types[i]) {
+      case INT:
+        vtypes[i] = GRB_INTEGER;
+        break;
+      case BIN:
+        vtypes[i] = GRB_BINARY;
+        break;
+      case CONT:
+        vtypes[i] = GRB_CONTINUOUS;
+        break;
+    }
+  }
+
+  std::vector<char*> names;
+  for (const auto& name : cols.names) {
+    names.push_back(const_cast<char*>(name.c_str()));
+  }
+
+  int error = GRBaddvars(
+      _model, cols.size(), 0, 0, 0, 0, const_cast<double*>(&cols.objCoefs[0]),
+      const_cast<double*>(&cols.lowBnds[0]),
+      const_cast<double*>(&cols.upBnds[0]), &vtypes[0],
+      names.size() ? &names[0] : 0);
+  if (error) {
+    throw std::runtime_error("Could not add variables");
+  }
+
+  int first = _numVars;
+  _numVars += cols.size();
+  return first;
+}
+
+// _____________________________________________________________________________
+int GurobiSolver::addRows(const RowBatch& rows) {
+  if (rows.size() == 0) return _numRows;
+
+  std::vector<char> senses(rows.size());
+  std::vector<int> starts(rows.size());
+  for (size_t i = 0; i < rows.size(); i++) {
+    starts[i] = rows.starts[i];
+    switch (rows.types[i]) {
+      case FIX:
+        senses[i] = GRB_EQUAL;
+        break;
+      case UP:
+        senses[i] = GRB_LESS_EQUAL;
+        break;
+      case LO:
+        senses[i] = GRB_GREATER_EQUAL;
+        break;
+    }
+  }
+
+  std::vector<char*> names;
+  for (const auto& name : rows.names) {
+    names.push_back(const_cast<char*>(name.c_str()));
+  }
+
+  int error = GRBaddconstrs(_model, rows.size(), rows.cols.size(), &starts[0],
+                            const_cast<int*>(rows.cols.data()),
+                            const_cast<double*>(rows.coefs.data()), &senses[0],
+                            const_cast<double*>(&rows.bnds[0]),
+                            names.size() ? &names[0] : 0);
+  if (error) {
+    throw std::runtime_error("Could not add rows");
+  }
+
+  int first = _numRows;
+  _numRows += rows.size();
+  return first;
+}
+
 // _____________________________________________________________________________
 void GurobiSolver::addColToRow(const std::string& rowName,
                                const std::string& colName, double coef) {
@@ -154,6 +233,14 @@ int GurobiSolver::getConstrByName(const std::string& name) const {
   return ret;
 }
 
+// _____________________________________________________________________________
+std::string GurobiSolver::getVarName(int colId) const {
+  char* ret;
+  int error = GRBgetstrattrelement(_model, GRB_STR_ATTR_VARNAME, colId, &ret);
+  if (error || !ret) return "";
+  return ret;
+}
+
 // _____________________________________________________________________________
 void GurobiSolver::addColToRow(int rowId, int colId, double coef) {
   int col = colId;
@@ -193,6 +280,18 @@ void GurobiSolver::setStarter(const StarterSol& starterSol) {
   }
 }
 
+// _____________________________________________________________________________
+void GurobiSolver::setStarter(const IdxStarterSol& starterSol) {
+  if (_starterArr) delete[] _starterArr;
+  _starterArr = new double[getNumVars()];
+  std::fill_n(_starterArr, getNumVars(), GRB_UNDEFINED);
+
+  for (const auto& varVal : starterSol) {
+    if (varVal.first < 0 || varVal.first >= getNumVars()) continue;
+    _starterArr[varVal.first] = varVal.second;
+  }
+}
+
 // _____________________________________________________________________________
 SolveType GurobiSolver::solve() {
   update();
@@ -6,8 +6,11 @@
 #define SHARED_OPTIM_ILPSOLVER_H_
 
 #include <fstream>
+#include <limits>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace shared {
 namespace optim {
@@ -19,6 +22,74 @@ enum SolveType { OPTIM, INF, NON_OPTIM };
 
 typedef std::map<std::string, int> StarterSol;
 
+// starter solution given as (column id, value) pairs
+typedef std::vector<std::pair<int, double>> IdxStarterSol;
+
+// a batch of columns, added to the problem in a single call. names are
+// optional, they are either empty or hold one name per column
+struct ColBatch {
+  std::vector<ColType> types;
+  std::vector<double> objCoefs;
+  std::vector<double> lowBnds;
+  std::vector<double> upBnds;
+  std::vector<std::string> names;
+
+  size_t size() const { return types.size(); }
+
+  // binary columns are bound to [0, 1], all others are unbounded
+  void add(ColType type, double objCoef) {
+    if (type == BIN) {
+      add(type, objCoef, 0, 1);
+    } else {
+      add(type, objCoef, -std::numeric_limits<double>::max(),
+          std::numeric_limits<double>::max());
+    }
+  }
+
+  void add(ColType type, double objCoef, double lowBnd, double upBnd) {
+    types.push_back(type);
+    objCoefs.push_back(objCoef);
+    lowBnds.push_back(lowBnd);
+    upBnds.push_back(upBnd);
+  }
+};
+
+// a batch of rows in compressed sparse row form, added to the problem in a
+// single call. the coefficients of row i are at [starts[i], starts[i + 1])
+// in cols and coefs. names are optional, as for ColBatch
+struct RowBatch {
+  std::vector<double> bnds;
+  std::vector<RowType> types;
+  std::vector<size_t> starts{0};
+  std::vector<int> cols;
+  std::vector<double> coefs;
+  std::vector<std::string> names;
+
+  size_t size() const { return types.size(); }
+
+  // start a new row, subsequent addCoef() calls write into it
+  void add(double bnd, RowType type) {
+    bnds.push_back(bnd);
+    types.push_back(type);
+    starts.push_back(starts.back());
+  }
+
+  void addCoef(int colId, double coef) {
+    cols.push_back(colId);
+    coefs.push_back(coef);
+    starts.back()++;
+  }
+
+  // remove the last row again if no coefficients were written into it
+  void dropEmpty() {
+    if (types.empty() || starts[starts.size() - 2] != starts.back()) return;
+    bnds.pop_back();
+    types.pop_back();
+    starts.pop_back();
+    if (names.size() > types.size()) names.pop_back();
+  }
+};
+
 class ILPSolver {
  public:
   ILPSolver(){};
@@ -30,6 +101,11 @@ class ILPSolver {
                      double lowBnd, double upBnd) = 0;
   virtual int addRow(const std::string& name, double bnd, RowType rowType) = 0;
 
+  // add all columns / rows of a batch, return the id of the first one. the
+  // batch rows may only reference columns which have already been added
+  virtual int addCols(const ColBatch& cols) = 0;
+  virtual int addRows(const RowBatch& rows) = 0;
+
   virtual void addColToRow(const std::string& rowName,
                            const std::string& colName, double coef) = 0;
   virtual void addColToRow(int rowId, int colId, double coef) = 0;
@@ -37,6 +113,9 @@ class ILPSolver {
   virtual int getVarByName(const std::string& name) const = 0;
   virtual int getConstrByName(const std::string& name) const = 0;
 
+  // the name of a column, empty if it has none
+  virtual std::string getVarName(int colId) const = 0;
+
   virtual void setObjCoef(const std::string& name, double coef) const = 0;
   virtual void setObjCoef(int colId, double coef) const = 0;
 
@@ -62,6 +141,7 @@ class ILPSolver {
   virtual double getObjVal() const = 0;
 
   virtual void setStarter(const StarterSol& starterSol) = 0;
+  virtual void setStarter(const IdxStarterSol& starterSol) = 0;
 
   virtual int getNumConstrs() const = 0;
   virtual int getNumVars() const = 0;
@@ -73,6 +153,16 @@ class ILPSolver {
 
     for (auto kv : sol) fo << kv.first << "\t" << kv.second << "\n";
   }
+  void writeMst(const std::string& path, const IdxStarterSol& sol) const {
+    std::ofstream fo;
+    fo.open(path);
+
+    for (auto kv : sol) {
+      std::string name = getVarName(kv.first);
+      if (name.empty()) continue;
+      fo << name << "\t" << kv.second << "\n";
+    }
+  }
 };
 
 }  // namespace optim
@@ -145,6 +145,76 @@ void ILPSolverTest::run() {
       TEST(s->getVarVal("y"), ==, approx(0));
       TEST(s->getVarVal("z"), ==, approx(1));
 
+      TEST(s->getObjVal(), ==, approx(3));
+    }
+  }
+  {
+    std::vector<ILPSolver*> solvers;
+
+#ifdef GUROBI_FOUND
+    try {
+      solvers.push_back(new GurobiSolver(shared::optim::MAX));
+    } catch (const std::exception& e) {
+    }
+#endif
+
+#ifdef GLPK_FOUND
+    solvers.push_back(new GLPKSolver(shared::optim::MAX));
+#endif
+
+#ifdef COIN_FOUND
+    solvers.push_back(new COINSolver(shared::optim::MAX));
+#endif
+
+    for (auto s : solvers) {
+      shared::optim::ColBatch cols;
+      cols.add(shared::optim::BIN, 1);
+      cols.add(shared::optim::BIN, 1);
+      cols.add(shared::optim::BIN, 2);
+
+      TEST(s->addCols(cols), ==, 0);
+
+      shared::optim::RowBatch rows;
+      rows.add(4, shared::optim::UP);
+      rows.addCoef(0, 1);
+      rows.addCoef(1, 2);
+      rows.addCoef(2, 3);
+
+      rows.add(1, shared::optim::LO);
+      rows.addCoef(0, 1);
+      rows.addCoef(1, 1);
+
+      TEST(rows.starts.size(), ==, 3);
+      TEST(rows.starts[1], ==, 3);
+      TEST(rows.starts[2], ==, 5);
+
+      TEST(s->addRows(rows), ==, 0);
+
+      s->update();
+
+      TEST(s->getNumVars(), ==, 3);
+      TEST(s->getNumConstrs(), ==, 2);
+
+      // a second batch continues the column ids
+      shared::optim::ColBatch more;
+      more.add(shared::optim::INT, 0, 0, 0);
+      more.names.push_back("w");
+
+      TEST(s->addCols(more), ==, 3);
+
+      s->update();
+
+      TEST(s->getVarByName("w"), ==, 3);
+      TEST(s->getVarName(3), ==, "w");
+
+      auto ret = s->solve();
+
+      TEST(ret, ==, shared::optim::OPTIM);
+
+      TEST(s->getVarVal(0), ==, approx(1));
+      TEST(s->getVarVal(1), ==, approx(0));
+      TEST(s->getVarVal(2), ==, approx(1));
+
       TEST(s->getObjVal(), ==, approx(3));
     }
   }